@@ -36,9 +36,8 @@ typedef void (*ActionWorkspaceFn)(NeuroIndex ws);
 
 static void process_workspace(const ActionWorkspaceFn awsf, NeuroIndex ws) {
   assert(awsf);
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   awsf(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 static void process_client(const ActionClientFn acf, NeuroClientPtrPtr c, const NeuroClientSelectorFn csf,
@@ -47,10 +46,8 @@ static void process_client(const ActionClientFn acf, NeuroClientPtrPtr c, const
   assert(csf);
   if (!c)
     return;
-  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   acf(c, csf, data);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 
@@ -255,45 +252,39 @@ void NeuroActionHandlerStopCpuCalc(NeuroArg null_arg) {
 // Layout
 void NeuroActionHandlerChangeLayout(NeuroArg int_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutChange(ws, NEURO_ARG_INT_GET(int_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 void NeuroActionHandlerResetLayout(NeuroArg null_arg) {
   (void)null_arg;
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutReset(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 void NeuroActionHandlerToggleLayout(NeuroArg idx_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutToggle(ws, NEURO_ARG_IDX_GET(idx_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 void NeuroActionHandlerToggleModLayout(NeuroArg lmod_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutToggleModCurr(ws, NEURO_ARG_LMOD_GET(lmod_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 void NeuroActionHandlerIncreaseMasterLayout(NeuroArg int_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutIncreaseMaster(ws, NEURO_ARG_INT_GET(int_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 void NeuroActionHandlerResizeMasterLayout(NeuroArg float_arg) {
   const NeuroIndex ws = NeuroCoreGetCurrStack();
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroLayoutResizeMaster(ws, NEURO_ARG_FLOAT_GET(float_arg));
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  NeuroClientFlushUpdates();
 }
 
 // NeuroWorkspace
@@ -326,6 +317,7 @@ void NeuroActionHandlerToggleScratchpad(NeuroArg command_arg) {
   NeuroClientPtrPtr nspc = NeuroCoreFindNspClient();
   const NeuroIndex ws = NeuroCoreGetCurrStack();
   const NeuroIndex nspws = NeuroCoreGetNspStack();
+  NeuroClientBeginTransaction();
   if (nspc && NEURO_CLIENT_PTR(nspc)->ws == ws) {
     NeuroWorkspaceClientSend(nspc, NeuroClientSelectorSelf, (const void *)&nspws);
     // process_client(NeuroWorkspaceClientSend, nspc, NeuroClientSelectorSelf, (const void *)&nspws);
@@ -340,6 +332,7 @@ void NeuroActionHandlerToggleScratchpad(NeuroArg command_arg) {
       NeuroSystemSpawn(NEURO_ARG_CMD_GET(command_arg), NULL);
     }
   }
+  NeuroClientEndTransaction();
 }
 
 // Curr NeuroClient
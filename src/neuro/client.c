@@ -22,6 +22,12 @@
 #include "workspace.h"
 #include "event.h"
 
+// Defines
+#define STEP_SIZE_REALLOC 32
+#define CLIENT_STATE_REQUESTS 3  // XSetWindowBorder, XSetWindowBorderWidth and XMoveResizeWindow
+#define XMOTION_MASK (ButtonPressMask|ButtonReleaseMask|PointerMotionMask)
+#define DRAG_SYNC_TIMEOUT 250U  // Milliseconds a client has to acknowledge a sync request before the next update
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
@@ -29,68 +35,265 @@
 // XMotionUpdaterFn
 typedef void (*XMotionUpdaterFn)(NeuroRectangle *r, const NeuroRectangle *c, int ex, int ey, const NeuroPoint *p);
 
+// Drag (client moved or resized with the mouse)
+typedef struct Drag Drag;
+struct Drag {
+  NeuroClientPtrPtr c;
+  NeuroRenderContext rc;
+  NeuroRectangle last_region;  // Region of the last update
+  uint64_t interval;           // Minimum milliseconds between updates of clients that do not sync
+  uint64_t last_update;        // Time of the last update
+  XSyncCounter counter;        // _NET_WM_SYNC_REQUEST counter of the client, None if it does not sync
+  XSyncAlarm alarm;            // Alarm triggered when the client acknowledges the last update
+  int64_t sync_value;          // Value of the last sync request
+  bool is_waiting;             // Whether the last update is not acknowledged yet
+};
+
+// ColorSetter (context version of a legacy color setter)
+typedef struct ColorSetter ColorSetter;
+struct ColorSetter {
+  const NeuroColorSetterFn setter_fn;
+  const NeuroColorContextSetterFn context_setter_fn;
+};
+
+// BorderSetter (context version of a legacy border setter)
+typedef struct BorderSetter BorderSetter;
+struct BorderSetter {
+  const NeuroBorderSetterFn setter_fn;
+  const NeuroBorderContextSetterFn context_setter_fn;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Windows queued for the next flush, a window is only queued once per batch
+static Window *pending_wins_ = NULL;
+static NeuroIndex pending_size_ = 0U;
+static NeuroIndex pending_capacity_ = 0U;
+static NeuroIndex pending_batch_ = 1U;
+
+// Request counters
+static NeuroIndex emitted_requests_ = 0U;
+static NeuroIndex suppressed_requests_ = 0U;
+
+// Transaction nesting depth and server grab, see NeuroClientBeginTransaction
+static NeuroIndex transaction_depth_ = 0U;
+static bool is_server_grabbed_ = false;
+static uint64_t grab_time_ = 0U;
+
+// Built-in setters, so that configs using the legacy ones also run the context versions
+static const ColorSetter color_setters_[] = {
+  { NeuroClientColorSetterCurr, NeuroClientColorContextSetterCurr },
+  { NeuroClientColorSetterAll, NeuroClientColorContextSetterAll },
+  { NeuroClientColorSetterNone, NeuroClientColorContextSetterNone }
+};
+static const BorderSetter border_width_setters_[] = {
+  { NeuroClientBorderWidthSetterAlways, NeuroClientBorderWidthContextSetterAlways },
+  { NeuroClientBorderWidthSetterNever, NeuroClientBorderWidthContextSetterNever },
+  { NeuroClientBorderWidthSetterSmart, NeuroClientBorderWidthContextSetterSmart },
+  { NeuroClientBorderWidthSetterCurr, NeuroClientBorderWidthContextSetterCurr }
+};
+static const BorderSetter border_gap_setters_[] = {
+  { NeuroClientBorderGapSetterAlways, NeuroClientBorderGapContextSetterAlways },
+  { NeuroClientBorderGapSetterNever, NeuroClientBorderGapContextSetterNever },
+  { NeuroClientBorderGapSetterSmart, NeuroClientBorderGapContextSetterSmart },
+  { NeuroClientBorderGapSetterCurr, NeuroClientBorderGapContextSetterCurr }
+};
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static bool is_protocol_delete(Window w) {
+static bool has_protocol(Window w, Atom protocol) {
   Atom *protocols = NULL;
   bool ret = false;
   int n = 0;
   if (XGetWMProtocols(NeuroSystemGetDisplay(), w, &protocols, &n)) {
     for (int i = 0; !ret && i < n; i++)
-      if (protocols[ i ] == NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_DELETEWINDOW))
+      if (protocols[ i ] == protocol)
         ret = true;
     XFree(protocols);
   }
   return ret;
 }
 
-static bool set_title_atom(NeuroClient *c, Atom atom) {
+static bool set_title_text(NeuroClient *c, const XTextProperty *tp) {
   assert(c);
-  XTextProperty tp;
-  XGetTextProperty(NeuroSystemGetDisplay(), c->win, &tp, atom);
-  if (!tp.nitems)
+  assert(tp);
+  if (!tp->nitems)
     return false;
-  if (tp.encoding == XA_STRING) {
-    strncpy(c->title, (char *)tp.value, NEURO_NAME_SIZE_MAX);
+  if (tp->encoding == XA_STRING) {
+    strncpy(c->info->title, (const char *)tp->value, NEURO_NAME_SIZE_MAX);
   } else {
     char **list = NULL;
     int n = 0;
-    if (XmbTextPropertyToTextList(NeuroSystemGetDisplay(), &tp, &list, &n) >= Success && n > 0 && list[ 0 ]) {
-      strncpy(c->title, list[ 0 ], NEURO_NAME_SIZE_MAX);
+    XTextProperty text = *tp;
+    if (XmbTextPropertyToTextList(NeuroSystemGetDisplay(), &text, &list, &n) >= Success && n > 0 && list[ 0 ]) {
+      strncpy(c->info->title, list[ 0 ], NEURO_NAME_SIZE_MAX);
       XFreeStringList(list);
     }
   }
-  XFree(tp.value);
   return true;
 }
 
-static void process_xmotion(NeuroRectangle *r, NeuroIndex ws, const NeuroRectangle *c, const NeuroPoint *p,
-    XMotionUpdaterFn xmuf, Cursor cursor) {
-  assert(r);
+static bool set_title_atom(NeuroClient *c, Atom atom) {
   assert(c);
-  assert(p);
+  XTextProperty tp;
+  XGetTextProperty(NeuroSystemGetDisplay(), c->win, &tp, atom);
+  const bool is_set = set_title_text(c, &tp);
+  if (tp.value)
+    XFree(tp.value);
+  return is_set;
+}
 
-  // Grab the pointer and set a cursor
-  if (GrabSuccess != XGrabPointer(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), false,
-      ButtonPressMask|ButtonReleaseMask|PointerMotionMask, GrabModeAsync, GrabModeAsync, None, cursor, CurrentTime))
-    return;
+// Adapters of the legacy setters configured in the current layout
+static NeuroColor legacy_color_setter(NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  return rc->layout->border_color_setter_fn(c);
+}
 
-  // process until the button is released
-  XEvent ev = { 0 };
-  do {
-    XMaskEvent(NeuroSystemGetDisplay(), ButtonPressMask|ButtonReleaseMask|PointerMotionMask, &ev);
-    if (ev.type == MotionNotify) {
-      xmuf(r, c, ev.xmotion.x, ev.xmotion.y, p);
-      NeuroLayoutRunCurr(ws);
-      NeuroWorkspaceUpdate(ws);
-    }
-  } while (ev.type != ButtonRelease);
+static int legacy_width_setter(NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  return rc->layout->border_width_setter_fn(c);
+}
+
+static int legacy_gap_setter(NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  return rc->layout->border_gap_setter_fn(c);
+}
+
+static NeuroColorContextSetterFn get_color_setter(const NeuroLayout *l) {
+  assert(l);
+  if (l->border_color_context_setter_fn)
+    return l->border_color_context_setter_fn;
+  for (NeuroIndex i = 0U; i < sizeof(color_setters_)/sizeof(ColorSetter); ++i)
+    if (color_setters_[ i ].setter_fn == l->border_color_setter_fn)
+      return color_setters_[ i ].context_setter_fn;
+  return legacy_color_setter;
+}
+
+static NeuroBorderContextSetterFn get_border_setter(NeuroBorderContextSetterFn context_setter_fn,
+    NeuroBorderSetterFn setter_fn, const BorderSetter *setters, NeuroIndex size, NeuroBorderContextSetterFn legacy_fn) {
+  if (context_setter_fn)
+    return context_setter_fn;
+  for (NeuroIndex i = 0U; i < size; ++i)
+    if (setters[ i ].setter_fn == setter_fn)
+      return setters[ i ].context_setter_fn;
+  return legacy_fn;
+}
 
-  // Ungrab the pointer
-  XUngrabPointer(NeuroSystemGetDisplay(), CurrentTime);
+static bool has_no_gap(const NeuroClient *c, const NeuroRenderContext *rc) {
+  return c->is_fullscreen || c->free_setter_fn != NeuroRuleFreeSetterNull || rc->is_float_layout;
+}
+
+static bool fills_region(const NeuroRectangle *r, const NeuroRenderContext *rc) {
+  return (r->w == rc->stack_region->w && r->h == rc->stack_region->h) ||
+      (r->w == rc->screen_region->w && r->h == rc->screen_region->h);
+}
+
+static bool reserve_pending(NeuroIndex total) {
+  if (total <= pending_capacity_)
+    return true;
+  const NeuroIndex new_capacity = pending_capacity_ > 0U ? 2U*pending_capacity_ : STEP_SIZE_REALLOC;
+  Window *const wins = (Window *)realloc(pending_wins_, new_capacity*sizeof(Window));
+  if (!wins)
+    return false;
+  pending_wins_ = wins;
+  pending_capacity_ = new_capacity;
+  return true;
+}
+
+static void send_client_state(NeuroClient *c) {
+  assert(c);
+  NeuroClientInfo *const info = c->info;
+  const NeuroClientState *const p = &info->pending, *const s = &info->shadow;
+  const bool force = !info->has_shadow;
+
+  // Windows are unmapped before they are moved and mapped after, so they never render in the hidden region
+  bool is_mapped = !s->is_hidden;
+  if (p->is_hidden && is_mapped) {
+    ++info->unmap_ignores;
+    XUnmapWindow(NeuroSystemGetDisplay(), c->win);
+    NeuroSystemSetWmState(c->win, IconicState);
+    emitted_requests_ += 2U;
+    is_mapped = false;
+  }
+
+  // The server unmaps and maps back a mapped window while it is reparented
+  if (p->parent != s->parent) {
+    if (is_mapped)
+      ++info->unmap_ignores;
+    XReparentWindow(NeuroSystemGetDisplay(), c->win, p->parent, p->region.p.x, p->region.p.y);
+    ++emitted_requests_;
+  }
+  NeuroIndex emitted = 0U;
+  if (force || p->border_color != s->border_color) {
+    XSetWindowBorder(NeuroSystemGetDisplay(), c->win, p->border_color);
+    ++emitted;
+  }
+  if (force || p->border_width != s->border_width) {
+    XSetWindowBorderWidth(NeuroSystemGetDisplay(), c->win, p->border_width);
+    ++emitted;
+  }
+  if (force || memcmp(&p->region, &s->region, sizeof(NeuroRectangle))) {
+    XMoveResizeWindow(NeuroSystemGetDisplay(), c->win, p->region.p.x, p->region.p.y, p->region.w, p->region.h);
+    ++emitted;
+  }
+  if (!p->is_hidden && s->is_hidden) {
+    NeuroSystemSetWmState(c->win, NormalState);
+    XMapWindow(NeuroSystemGetDisplay(), c->win);
+    emitted_requests_ += 2U;
+  }
+  emitted_requests_ += emitted;
+  suppressed_requests_ += CLIENT_STATE_REQUESTS - emitted;
+  memmove(&info->shadow, p, sizeof(NeuroClientState));
+  info->has_shadow = true;
+}
+
+// Note: a window queued again in the same batch only keeps its latest pending state
+static bool queue_client(NeuroClient *c) {
+  assert(c);
+  if (c->info->pending_batch == pending_batch_) {
+    suppressed_requests_ += CLIENT_STATE_REQUESTS;
+    return true;
+  }
+  if (!reserve_pending(pending_size_ + 1U))
+    return false;
+  pending_wins_[ pending_size_++ ] = c->win;
+  c->info->pending_batch = pending_batch_;
+  return true;
+}
+
+// Sends the queued state of a single client, the rest of the queue is kept for its batch or transaction
+static void flush_client(NeuroClient *c) {
+  assert(c);
+  if (transaction_depth_ > 0U)
+    return;
+  const NeuroIndex emitted = emitted_requests_;
+  send_client_state(c);
+  if (emitted_requests_ != emitted)
+    NeuroSystemIgnoreCrossing();
+}
+
+// Note: the server does not send a ConfigureNotify if a configure request does not change the window
+static void send_configure_notify(const NeuroClient *c, const NeuroClientState *st, const NeuroRenderContext *rc) {
+  assert(c);
+  assert(st);
+  assert(rc);
+  XEvent e;
+  memset(&e, 0, sizeof(XEvent));
+  e.xconfigure.type = ConfigureNotify;
+  e.xconfigure.display = NeuroSystemGetDisplay();
+  e.xconfigure.event = c->win;
+  e.xconfigure.window = c->win;
+  e.xconfigure.x = st->region.p.x + rc->parent_origin.x;
+  e.xconfigure.y = st->region.p.y + rc->parent_origin.y;
+  e.xconfigure.width = st->region.w;
+  e.xconfigure.height = st->region.h;
+  e.xconfigure.border_width = st->border_width;
+  e.xconfigure.above = None;
+  e.xconfigure.override_redirect = false;
+  XSendEvent(NeuroSystemGetDisplay(), c->win, false, StructureNotifyMask, &e);
 }
 
 static void xmotion_move(NeuroRectangle *r, const NeuroRectangle *c, int ex, int ey, const NeuroPoint *p) {
@@ -104,28 +307,349 @@ static void xmotion_resize(NeuroRectangle *r, const NeuroRectangle *c, int ex, i
   r->h = c->h + (ey - (c->h + r->p.y));
 }
 
+static uint64_t get_time_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000U + (uint64_t)ts.tv_nsec/1000000U;
+}
+
+static void release_server(void) {
+  if (!is_server_grabbed_)
+    return;
+  XUngrabServer(NeuroSystemGetDisplay());
+  XFlush(NeuroSystemGetDisplay());
+  is_server_grabbed_ = false;
+}
+
+// Releases the server before the end of the transaction if it has been grabbed for too long
+static void check_grab_time(void) {
+  if (is_server_grabbed_ && get_time_ms() - grab_time_ >= (uint64_t)NeuroConfigGet()->max_grab_time)
+    release_server();
+}
+
+static int64_t get_sync_int(XSyncValue v) {
+  return (int64_t)XSyncValueHigh32(v) * 4294967296LL + (int64_t)XSyncValueLow32(v);
+}
+
+static XSyncValue get_sync_value(int64_t i) {
+  XSyncValue v;
+  XSyncIntsToValue(&v, (unsigned int)(i & 0xffffffffLL), (int)(i / 4294967296LL));
+  return v;
+}
+
+static XSyncCounter get_sync_counter(Window w) {
+  if (!NeuroSystemHasSync() || !has_protocol(w, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNC_REQUEST)))
+    return None;
+  Atom type = None;
+  int format = 0;
+  unsigned long n = 0UL, after = 0UL;
+  unsigned char *data = NULL;
+  if (XGetWindowProperty(NeuroSystemGetDisplay(), w, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNC_REQUEST_COUNTER),
+      0L, 1L, false, XA_CARDINAL, &type, &format, &n, &after, &data) != Success)
+    return None;
+  const XSyncCounter counter = data && format == 32 && n == 1UL ? (XSyncCounter)*(unsigned long *)(void *)data : None;
+  if (data)
+    XFree(data);
+  return counter;
+}
+
+// Note: only resizes are synced, clients do not need to redraw when they are moved
+static void start_drag_sync(Drag *d) {
+  assert(d);
+  Display *const dpy = NeuroSystemGetDisplay();
+  d->counter = get_sync_counter(NEURO_CLIENT_PTR(d->c)->win);
+  XSyncValue v;
+  if (d->counter == None || !XSyncQueryCounter(dpy, d->counter, &v)) {
+    d->counter = None;
+    return;
+  }
+  d->sync_value = get_sync_int(v);
+
+  // The alarm notifies when the counter reaches the value of the last sync request
+  XSyncAlarmAttributes attr;
+  attr.trigger.counter = d->counter;
+  attr.trigger.value_type = XSyncAbsolute;
+  attr.trigger.wait_value = get_sync_value(d->sync_value + 1);
+  attr.trigger.test_type = XSyncPositiveComparison;
+  XSyncIntToValue(&attr.delta, 0);
+  attr.events = true;
+  d->alarm = XSyncCreateAlarm(dpy, XSyncCACounter|XSyncCAValueType|XSyncCAValue|XSyncCATestType|XSyncCADelta|
+      XSyncCAEvents, &attr);
+  if (d->alarm == None)
+    d->counter = None;
+}
+
+static void check_drag_sync(Drag *d) {
+  assert(d);
+  if (d->alarm == None)
+    return;
+  XEvent ev;
+  while (XCheckTypedEvent(NeuroSystemGetDisplay(), NeuroSystemGetSyncEventBase() + XSyncAlarmNotify, &ev)) {
+    XSyncAlarmNotifyEvent ae;
+    memmove(&ae, &ev, sizeof(XSyncAlarmNotifyEvent));
+    if (ae.alarm == d->alarm && get_sync_int(ae.counter_value) >= d->sync_value)
+      d->is_waiting = false;
+  }
+}
+
+static void stop_drag_sync(Drag *d) {
+  assert(d);
+  if (d->alarm == None)
+    return;
+  XSyncDestroyAlarm(NeuroSystemGetDisplay(), d->alarm);
+  XSync(NeuroSystemGetDisplay(), false);
+  check_drag_sync(d);
+  d->alarm = None;
+}
+
+// Note: sync clients are updated as soon as they acknowledge the last update, the rest once per interval
+static uint64_t get_drag_due(const Drag *d) {
+  assert(d);
+  if (d->counter == None)
+    return d->last_update + d->interval;
+  return d->is_waiting ? d->last_update + DRAG_SYNC_TIMEOUT : 0U;
+}
+
+static void send_drag_sync(Drag *d) {
+  assert(d);
+  Display *const dpy = NeuroSystemGetDisplay();
+  ++d->sync_value;
+  XSyncAlarmAttributes attr;
+  attr.trigger.wait_value = get_sync_value(d->sync_value);
+  XSyncChangeAlarm(dpy, d->alarm, XSyncCAValue, &attr);
+
+  // The client sets the counter to the value once it handled the configure that follows
+  const Window win = NEURO_CLIENT_PTR(d->c)->win;
+  XEvent se;
+  memset(&se, 0, sizeof(XEvent));
+  se.type = ClientMessage;
+  se.xclient.window = win;
+  se.xclient.message_type = NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_PROTOCOLS);
+  se.xclient.format = 32;
+  se.xclient.data.l[ 0 ] = (long)NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_SYNC_REQUEST);
+  se.xclient.data.l[ 1 ] = CurrentTime;
+  se.xclient.data.l[ 2 ] = (long)(d->sync_value & 0xffffffffLL);
+  se.xclient.data.l[ 3 ] = (long)(d->sync_value / 4294967296LL);
+  XSendEvent(dpy, win, false, NoEventMask, &se);
+  d->is_waiting = true;
+}
+
+// Note: it returns false without reading an event if the pending motion is due before the next pointer event
+static bool next_pointer_event(XEvent *ev, bool is_pending, Drag *d) {
+  assert(ev);
+  assert(d);
+  Display *const dpy = NeuroSystemGetDisplay();
+  while (is_pending) {
+    if (XCheckMaskEvent(dpy, XMOTION_MASK, ev))
+      return true;
+    check_drag_sync(d);
+    const uint64_t now = get_time_ms(), due = get_drag_due(d);
+    if (now >= due)
+      return false;
+    struct pollfd pfd = { ConnectionNumber(dpy), POLLIN, 0 };
+    if (poll(&pfd, 1, (int)(due - now)) <= 0)
+      return false;
+  }
+  XMaskEvent(dpy, XMOTION_MASK, ev);
+  return true;
+}
+
+// Note: tiled clients are not updated, their float region is only visible after the relayout
+static void update_dragged_client(Drag *d, const NeuroRectangle *r) {
+  assert(d);
+  assert(r);
+  d->last_update = get_time_ms();
+  if (!memcmp(&d->last_region, r, sizeof(NeuroRectangle)))
+    return;
+  memmove(&d->last_region, r, sizeof(NeuroRectangle));
+  if (NEURO_CLIENT_PTR(d->c)->free_setter_fn == NeuroRuleFreeSetterNull && !NeuroLayoutRunClient(d->c))
+    return;
+  NeuroClientUpdateWithContext(d->c, &d->rc);
+
+  // Clamped regions may leave the window unchanged, the client would never acknowledge a sync without a configure
+  const NeuroClientInfo *const info = NEURO_CLIENT_PTR(d->c)->info;
+  if (d->counter != None &&
+      (!info->has_shadow || memcmp(&info->pending.region, &info->shadow.region, sizeof(NeuroRectangle))))
+    send_drag_sync(d);
+  NeuroClientFlushUpdates();
+}
+
+static void process_xmotion(NeuroClientPtrPtr c, NeuroRectangle *r, const NeuroRectangle *cr, const NeuroPoint *p,
+    XMotionUpdaterFn xmuf, Cursor cursor) {
+  assert(c);
+  assert(r);
+  assert(cr);
+  assert(p);
+
+  // Grab the pointer and set a cursor
+  Display *const dpy = NeuroSystemGetDisplay();
+  if (GrabSuccess != XGrabPointer(dpy, NeuroSystemGetRoot(), false, XMOTION_MASK, GrabModeAsync, GrabModeAsync, None,
+      cursor, CurrentTime))
+    return;
+
+  // Set up the drag, resizes of clients that support it are synced
+  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
+  const int rate = NeuroConfigGet()->motion_rate;
+  Drag d = { c, { 0 }, *r, rate > 0 ? 1000U / (uint64_t)rate : 0U, 0U, None, None, 0, false };
+  NeuroClientGetRenderContext(&d.rc, ws);
+  if (xmuf == xmotion_resize)
+    start_drag_sync(&d);
+
+  // Process until the button is released, only the latest motion is applied once it is due
+  int ex = 0, ey = 0;
+  bool is_pending = false;
+  XEvent ev = { 0 };
+  do {
+    if (!next_pointer_event(&ev, is_pending, &d)) {
+      xmuf(r, cr, ex, ey, p);
+      update_dragged_client(&d, r);
+      is_pending = false;
+      continue;
+    }
+    if (ev.type == MotionNotify) {
+      while (XCheckMaskEvent(dpy, PointerMotionMask, &ev))
+        continue;
+      ex = ev.xmotion.x;
+      ey = ev.xmotion.y;
+      is_pending = true;
+    }
+  } while (ev.type != ButtonRelease);
+  if (is_pending)
+    xmuf(r, cr, ex, ey, p);
+  stop_drag_sync(&d);
+
+  // Ungrab the pointer and run the layout once
+  XUngrabPointer(dpy, CurrentTime);
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRunCurr(ws);
+  NeuroWorkspaceUpdate(ws);
+  NeuroClientFlushUpdates();
+}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Update queue
+bool NeuroClientInit(void) {
+  return reserve_pending(STEP_SIZE_REALLOC);
+}
+
+void NeuroClientStop(void) {
+  free(pending_wins_);
+  pending_wins_ = NULL;
+  pending_size_ = 0U;
+  pending_capacity_ = 0U;
+  ++pending_batch_;
+}
+
+// Note: windows that are not in a stack anymore (unmanaged or minimized) are skipped
+// Note: inside a transaction the queue is kept, it is flushed once when the outermost transaction ends
+void NeuroClientFlushUpdates(void) {
+  if (transaction_depth_ > 0U) {
+    check_grab_time();
+    return;
+  }
+  const NeuroIndex emitted = emitted_requests_;
+  for (NeuroIndex i = 0U; i < pending_size_; ++i) {
+    const NeuroClientPtrPtr c = NeuroCoreFindWindowClient(pending_wins_[ i ]);
+    if (!c || NEURO_CLIENT_PTR(c)->info->pending_batch != pending_batch_) {
+      suppressed_requests_ += CLIENT_STATE_REQUESTS;
+      continue;
+    }
+    send_client_state(NEURO_CLIENT_PTR(c));
+  }
+  pending_size_ = 0U;
+  ++pending_batch_;
+  if (emitted_requests_ != emitted)
+    NeuroSystemIgnoreCrossing();
+}
+
+void NeuroClientResetShadow(NeuroClientPtrPtr c) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->info->has_shadow = false;
+}
+
+NeuroIndex NeuroClientGetEmittedRequests(void) {
+  return emitted_requests_;
+}
+
+NeuroIndex NeuroClientGetSuppressedRequests(void) {
+  return suppressed_requests_;
+}
+
+// Transactions nest, only the outermost one grabs the server, if max_grab_time allows it
+void NeuroClientBeginTransaction(void) {
+  if (transaction_depth_++ > 0U || NeuroConfigGet()->max_grab_time <= 0)
+    return;
+  XGrabServer(NeuroSystemGetDisplay());
+  is_server_grabbed_ = true;
+  grab_time_ = get_time_ms();
+}
+
+void NeuroClientEndTransaction(void) {
+  assert(transaction_depth_ > 0U);
+  if (transaction_depth_ == 0U || --transaction_depth_ > 0U)
+    return;
+  NeuroClientFlushUpdates();
+  NeuroWorkspaceMapPendingContainers();
+  release_server();
+}
+
+bool NeuroClientIsInTransaction(void) {
+  return transaction_depth_ > 0U;
+}
+
+// Render Context
+NeuroRenderContext *NeuroClientGetRenderContext(NeuroRenderContext *dst, NeuroIndex ws) {
+  assert(dst);
+  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(ws);
+  dst->ws = ws;
+  dst->layout = l;
+  dst->stack_region = NeuroCoreStackGetRegion(ws);
+  dst->screen_region = NeuroSystemGetScreenRegion();
+  dst->gaps = NeuroCoreStackGetGaps(ws);
+  dst->border_width = NeuroConfigGet()->border_width;
+  dst->border_gap = NeuroConfigGet()->border_gap;
+  dst->is_float_layout = l->arranger_fn == NeuroLayoutArrangerFloat ||
+      l->dense_arranger_fn == NeuroLayoutDenseArrangerFloat;
+  dst->has_fixed_client = NeuroCoreStackGetAttributeNum(ws, NEURO_CORE_ATTRIBUTE_FIXED) > 0U;
+  dst->is_hidden = NeuroWorkspaceIsUnmapped(ws);
+  dst->parent = NeuroWorkspaceGetContainer(&dst->parent_origin, ws);
+  dst->color_setter_fn = get_color_setter(l);
+  dst->width_setter_fn = get_border_setter(l->border_width_context_setter_fn, l->border_width_setter_fn,
+      border_width_setters_, sizeof(border_width_setters_)/sizeof(BorderSetter), legacy_width_setter);
+  dst->gap_setter_fn = get_border_setter(l->border_gap_context_setter_fn, l->border_gap_setter_fn,
+      border_gap_setters_, sizeof(border_gap_setters_)/sizeof(BorderSetter), legacy_gap_setter);
+  return dst;
+}
+
 // Basic Functions
 void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data) {
   (void)data;
+  NeuroClientUpdateWithContext(c, NULL);
+}
+
+// Note: rc is the render context of the client stack, it is computed for the client if NULL
+void NeuroClientUpdateWithContext(NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
   if (!c)
     return;
 
-  // Get workspace and regions
+  // Get render context and regions
   NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  const NeuroRectangle *const stack_region = NeuroCoreStackGetRegion(client->ws);
+  NeuroRenderContext crc;
+  if (!rc)
+    rc = NeuroClientGetRenderContext(&crc, client->ws);
   NeuroRectangle *const client_region = NeuroCoreClientGetRegion(c);
 
   // Priority: Fullscreen > Free > Fixed > Tiled
   NeuroRectangle r;
   if (client->is_fullscreen) {
-    NeuroGeometryRectangleGetIncreased(&r, stack_region, NeuroCoreStackGetGaps(client->ws));
+    NeuroGeometryRectangleGetIncreased(&r, rc->stack_region, rc->gaps);
   } else if (client->free_setter_fn != NeuroRuleFreeSetterNull) {
-    client->free_setter_fn(client_region, stack_region);
+    client->free_setter_fn(client_region, rc->stack_region);
     memmove(&r, client_region, sizeof(NeuroRectangle));
   } else if (client->fixed_pos != NEURO_FIXED_POSITION_NULL) {
     NeuroRuleSetClientRegion(&r, c);
@@ -134,19 +658,91 @@ void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data) {
   }
 
   // Set border width and border gap
-  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
-  const int border_width = l->border_width_setter_fn(c);
-  const int border_gap = l->border_gap_setter_fn(c);
+  const int border_width = rc->width_setter_fn(c, rc);
+  const int border_gap = rc->gap_setter_fn(c, rc);
   NeuroGeometryRectangleSetBorderWidthAndGap(&r, border_width, border_gap);
   if (r.w < 1)
     r.w = 1;
   if (r.h < 1)
     r.h = 1;
+  r.p.x -= rc->parent_origin.x;
+  r.p.y -= rc->parent_origin.y;
+
+  // Queue the new state, it is sent right away if it can not be queued
+  NeuroClientState *const p = &client->info->pending;
+  memmove(&p->region, &r, sizeof(NeuroRectangle));
+  p->border_width = border_width;
+  p->border_color = rc->color_setter_fn(c, rc);
+  p->is_hidden = rc->is_hidden;
+  p->parent = rc->parent;
+  if (!queue_client(client)) {
+    send_client_state(client);
+    NeuroSystemIgnoreCrossing();
+  }
+}
 
-  // Draw
-  XSetWindowBorder(NeuroSystemGetDisplay(), client->win, l->border_color_setter_fn(c));
-  XSetWindowBorderWidth(NeuroSystemGetDisplay(), client->win, border_width);
-  XMoveResizeWindow(NeuroSystemGetDisplay(), client->win, r.p.x, r.p.y, r.w, r.h);
+// Note: tiled clients keep their geometry and stacking, they are only told the geometry they were last sent
+// Note: stacking requests are never passed to the server, so the stacking order kept by the WM stays known
+void NeuroClientConfigure(NeuroClientPtrPtr c, const XConfigureRequestEvent *ev) {
+  if (!c || !ev)
+    return;
+
+  // Free and floating clients are updated alone
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  NeuroRenderContext rc;
+  NeuroClientGetRenderContext(&rc, client->ws);
+  if (!NeuroClientRequestRegion(c, ev, &rc)) {
+    // The ConfigureNotify of a pending relayout answers, and windows never sent a state have no geometry to report
+    if (!NeuroCoreStackIsRelayoutPending(client->ws) && client->info->has_shadow)
+      send_configure_notify(client, &client->info->shadow, &rc);
+    return;
+  }
+  flush_client(client);
+  send_configure_notify(client, &client->info->pending, &rc);
+
+  // They are restacked through the stacking model too
+  if (ev->value_mask & CWStackMode)
+    NeuroWorkspaceRestackClient(c, (ev->value_mask & CWSibling) ? ev->above : None, ev->detail);
+}
+
+// Applies the geometry request of a free or floating client to the region it is placed with and queues its update
+// Note: free setters other than Fit place the client themselves, so a client asking for a geometry is switched to Fit
+// Note: it returns false for tiled, fixed and fullscreen clients, their geometry is kept by the layout
+bool NeuroClientRequestRegion(NeuroClientPtrPtr c, const XConfigureRequestEvent *ev, const NeuroRenderContext *rc) {
+  if (!c || !ev || !rc)
+    return false;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  if (client->is_fullscreen)
+    return false;
+  if (client->free_setter_fn != NeuroRuleFreeSetterNull) {
+    if ((ev->value_mask & (CWX|CWY|CWWidth|CWHeight)) && client->free_setter_fn != NeuroRuleFreeSetterFit)
+      NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterFit);
+    NeuroClientApplyConfigureRequest(NeuroCoreClientGetRegion(c), ev, client->info);
+  } else if (rc->is_float_layout && !rc->has_fixed_client) {
+    NeuroClientApplyConfigureRequest(&client->float_region, ev, client->info);
+    NeuroLayoutRunClient(c);
+  } else {
+    return false;
+  }
+  NeuroClientUpdateWithContext(c, rc);
+  return true;
+}
+
+// Note: the request is applied as an offset from the last sent geometry, which does not include the border and gap
+void NeuroClientApplyConfigureRequest(NeuroRectangle *dst, const XConfigureRequestEvent *ev,
+    const NeuroClientInfo *info) {
+  if (!dst || !ev || !info)
+    return;
+  const NeuroRectangle *const s = &info->shadow.region;
+  const bool has_shadow = info->has_shadow;
+  if (ev->value_mask & CWX)
+    dst->p.x = has_shadow ? dst->p.x + ev->x - s->p.x : ev->x;
+  if (ev->value_mask & CWY)
+    dst->p.y = has_shadow ? dst->p.y + ev->y - s->p.y : ev->y;
+  if (ev->value_mask & CWWidth)
+    dst->w = has_shadow ? dst->w + ev->width - s->w : ev->width;
+  if (ev->value_mask & CWHeight)
+    dst->h = has_shadow ? dst->h + ev->height - s->h : ev->height;
 }
 
 void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data) {
@@ -154,20 +750,12 @@ void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data) {
   if (!c)
     return;
 
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
   XClassHint ch;
-  if (!XGetClassHint(NeuroSystemGetDisplay(), client->win, &ch))
+  if (!XGetClassHint(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, &ch))
     return;
 
-  // Reset class and name
-  assert(client->class);
-  client->class[ 0 ] = '\0';
-  assert(client->name);
-  client->name[ 0 ] = '\0';
-
-  // Set new class and name
-  strncpy(client->class, ch.res_class, NEURO_NAME_SIZE_MAX);
-  strncpy(client->name, ch.res_name, NEURO_NAME_SIZE_MAX);
+  // Set new interned class and name
+  NeuroClientSetClassAndName(c, ch.res_class, ch.res_name);
 
   // Clean up
   if (ch.res_class)
@@ -183,26 +771,48 @@ void NeuroClientUpdateTitle(NeuroClientPtrPtr c, const void *data) {
 
   // Reset title
   NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  assert(client->title);
-  client->title[ 0 ] = '\0';
+  assert(client->info);
+  client->info->title[ 0 ] = '\0';
 
   // Set new title
   if (!set_title_atom(client, NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_NAME)))
     set_title_atom(client, XA_WM_NAME);
 }
 
+void NeuroClientSetClassAndName(NeuroClientPtrPtr c, const char *class, const char *name) {
+  if (!c)
+    return;
+  const char *const iclass = NeuroCoreInternString(class ? class : "");
+  const char *const iname = NeuroCoreInternString(name ? name : "");
+  if (!iclass || !iname)
+    return;
+  NEURO_CLIENT_PTR(c)->info->class = iclass;
+  NEURO_CLIENT_PTR(c)->info->name = iname;
+}
+
+// Note: tp is the already fetched title property, NULL resets the title
+void NeuroClientSetTitle(NeuroClientPtrPtr c, const XTextProperty *tp) {
+  if (!c)
+    return;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  assert(client->info);
+  client->info->title[ 0 ] = '\0';
+  if (tp)
+    set_title_text(client, tp);
+}
+
 void NeuroClientSetUrgent(NeuroClientPtrPtr c, const void *data) {
   (void)data;
   if (!c)
     return;
-  NEURO_CLIENT_PTR(c)->is_urgent = true;
+  NeuroCoreClientSetUrgent(c, true);
 }
 
 void NeuroClientUnsetUrgent(NeuroClientPtrPtr c, const void *data) {
   (void)data;
   if (!c)
     return;
-  NEURO_CLIENT_PTR(c)->is_urgent = false;
+  NeuroCoreClientSetUrgent(c, false);
 }
 
 void NeuroClientKill(NeuroClientPtrPtr c, const void *data) {
@@ -210,7 +820,7 @@ void NeuroClientKill(NeuroClientPtrPtr c, const void *data) {
   if (!c)
     return;
   const Window win = NEURO_CLIENT_PTR(c)->win;
-  if (is_protocol_delete(win)) {
+  if (has_protocol(win, NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_DELETEWINDOW))) {
     XEvent ke;
     ke.type = ClientMessage;
     ke.xclient.window = win;
@@ -238,6 +848,8 @@ void NeuroClientMinimize(NeuroClientPtrPtr c, const void *data) {
   // Move client off screen
   XMoveWindow(NeuroSystemGetDisplay(), cli->win, NeuroSystemGetScreenRegion()->w + 1,
       NeuroSystemGetScreenRegion()->h + 1);
+  NeuroSystemIgnoreCrossing();
+  cli->info->has_shadow = false;
   NeuroLayoutRunCurr(cli->ws);
   NeuroWorkspaceFocus(cli->ws);
 }
@@ -252,7 +864,7 @@ void NeuroClientTile(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Tile the client
-  client->free_setter_fn = NeuroRuleFreeSetterNull;
+  NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterNull);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -267,7 +879,7 @@ void NeuroClientFree(NeuroClientPtrPtr c, const void *freeSetterFn) {
     return;
 
   // Free the client
-  client->free_setter_fn = gaf->FreeSetterFn_;
+  NeuroCoreClientSetFreeSetter(c, gaf->FreeSetterFn_);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -293,7 +905,7 @@ void NeuroClientNormal(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Normal the client
-  client->is_fullscreen = false;
+  NeuroCoreClientSetFullscreen(c, false);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -308,7 +920,7 @@ void NeuroClientFullscreen(NeuroClientPtrPtr c, const void *data) {
     return;
 
   // Fullscreen the client
-  client->is_fullscreen = true;
+  NeuroCoreClientSetFullscreen(c, true);
   NeuroLayoutRunCurr(client->ws);
   NeuroWorkspaceFocus(client->ws);
 }
@@ -343,7 +955,7 @@ void NeuroClientFloatMove(NeuroClientPtrPtr c, const void *data) {
   memmove(&cr, r, sizeof(NeuroRectangle));
   NeuroPoint p;
   NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
+  process_xmotion(c, r, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
 }
 
 void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *data) {
@@ -364,7 +976,7 @@ void NeuroClientFloatResize(NeuroClientPtrPtr c, const void *data) {
   memmove(&cr, r, sizeof(NeuroRectangle));
   NeuroPoint p;
   NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
+  process_xmotion(c, r, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
 }
 
 void NeuroClientFreeMove(NeuroClientPtrPtr c, const void *free_setter_fn) {
@@ -378,10 +990,9 @@ void NeuroClientFreeMove(NeuroClientPtrPtr c, const void *free_setter_fn) {
   // Free move the client
   NeuroRectangle *const r = NeuroCoreClientGetRegion(c), cr;
   memmove(&cr, r, sizeof(NeuroRectangle));
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
   NeuroPoint p;
   NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
+  process_xmotion(c, r, &cr, &p, xmotion_move, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
 }
 
 void NeuroClientFreeResize(NeuroClientPtrPtr c, const void *free_setter_fn) {
@@ -395,23 +1006,22 @@ void NeuroClientFreeResize(NeuroClientPtrPtr c, const void *free_setter_fn) {
   // Free resize the client
   NeuroRectangle *const r = NeuroCoreClientGetRegion(c), cr;
   memmove(&cr, r, sizeof(NeuroRectangle));
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
   NeuroPoint p;
   NeuroSystemGetPointerWindowLocation(&p, NULL);
-  process_xmotion(r, client->ws, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
+  process_xmotion(c, r, &cr, &p, xmotion_resize, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
 }
 
 // Find
 NeuroClientPtrPtr NeuroClientFindWindow(Window w) {
-  return NeuroCoreFindClient(NeuroClientTesterWindow, (const void *)&w);
+  return NeuroCoreFindWindowClient(w);
 }
 
 NeuroClientPtrPtr NeuroClientFindUrgent(void) {
-  return NeuroCoreFindClient(NeuroClientTesterUrgent, NULL);
+  return NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_URGENT);
 }
 
 NeuroClientPtrPtr NeuroClientFindFixed(void) {
-  return NeuroCoreFindClient(NeuroClientTesterFixed, NULL);
+  return NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_FIXED);
 }
 
 // Note: This might return a lower window in the stacking order, use NeuroClientGetPointedByPointer() to always get
@@ -429,9 +1039,18 @@ NeuroClientPtrPtr NeuroClientGetFocused(void) {
   return NeuroCoreStackGetCurrClient(NeuroCoreGetCurrStack());
 }
 
+// Note: if the clients are reparented, the pointer is queried again inside the pointed container
 NeuroClientPtrPtr NeuroClientGetPointedByPointer(void) {
   Window w;
   NeuroSystemGetPointerWindowLocation(NULL, &w);
+  if (w != None && NeuroWorkspaceIsContainer(w)) {
+    Window root = None, child = None;
+    int rx = 0, ry = 0, x = 0, y = 0;
+    unsigned int state = 0U;
+    if (!XQueryPointer(NeuroSystemGetDisplay(), w, &root, &child, &rx, &ry, &x, &y, &state))
+      return NULL;
+    w = child;
+  }
   return NeuroClientFindWindow(w);
 }
 
@@ -454,9 +1073,11 @@ bool NeuroClientTesterPointed(const NeuroClientPtrPtr c, const void *p) {
   return c && p && NeuroGeometryIsPointInRectangle(NeuroCoreClientGetRegion(c), (const NeuroPoint *)p);
 }
 
+// Note: stacks hidden in their container keep their region, so the clients of stacks without monitor are hidden too
 bool NeuroClientTesterHidden(const NeuroClientPtrPtr c, const void *data) {
   (void)data;
-  return c && NeuroGeometryIsPointInRectangle(NeuroSystemGetHiddenRegion(), &NeuroCoreClientGetRegion(c)->p);
+  return c && (!NeuroCoreStackGetMonitor(NEURO_CLIENT_PTR(c)->ws) ||
+      NeuroGeometryIsPointInRectangle(NeuroSystemGetHiddenRegion(), &NeuroCoreClientGetRegion(c)->p));
 }
 
 bool NeuroClientTesterFullscreen(const NeuroClientPtrPtr c, const void *data) {
@@ -558,16 +1179,80 @@ NeuroClientPtrPtr NeuroClientSelectorRight(const NeuroClientPtrPtr c) {
 
 // Color Setters
 NeuroColor NeuroClientColorSetterCurr(const NeuroClientPtrPtr c) {
+  return NeuroClientColorContextSetterCurr(c, NULL);
+}
+
+NeuroColor NeuroClientColorSetterAll(const NeuroClientPtrPtr c) {
+  return NeuroClientColorContextSetterAll(c, NULL);
+}
+
+NeuroColor NeuroClientColorSetterNone(const NeuroClientPtrPtr c) {
+  return NeuroClientColorContextSetterNone(c, NULL);
+}
+
+// Border Width Setters
+int NeuroClientBorderWidthSetterAlways(const NeuroClientPtrPtr c) {
+  (void)c;
+  return NeuroConfigGet()->border_width;
+}
+
+int NeuroClientBorderWidthSetterNever(const NeuroClientPtrPtr c) {
+  return NeuroClientBorderWidthContextSetterNever(c, NULL);
+}
+
+int NeuroClientBorderWidthSetterSmart(const NeuroClientPtrPtr c) {
   if (!c)
-    NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
+    return 0;
+  NeuroRenderContext rc;
+  return NeuroClientBorderWidthContextSetterSmart(c, NeuroClientGetRenderContext(&rc, NEURO_CLIENT_PTR(c)->ws));
+}
+
+int NeuroClientBorderWidthSetterCurr(const NeuroClientPtrPtr c) {
+  if (!c)
+    return 0;
+  return NeuroCoreClientIsCurr(c) ? NeuroConfigGet()->border_width : 0;
+}
+
+// Border Gap Setters
+int NeuroClientBorderGapSetterAlways(const NeuroClientPtrPtr c) {
+  if (!c)
+    return 0;
+  NeuroRenderContext rc;
+  return NeuroClientBorderGapContextSetterAlways(c, NeuroClientGetRenderContext(&rc, NEURO_CLIENT_PTR(c)->ws));
+}
+
+int NeuroClientBorderGapSetterNever(const NeuroClientPtrPtr c) {
+  return NeuroClientBorderGapContextSetterNever(c, NULL);
+}
+
+int NeuroClientBorderGapSetterSmart(const NeuroClientPtrPtr c) {
+  if (!c)
+    return 0;
+  NeuroRenderContext rc;
+  return NeuroClientBorderGapContextSetterSmart(c, NeuroClientGetRenderContext(&rc, NEURO_CLIENT_PTR(c)->ws));
+}
+
+int NeuroClientBorderGapSetterCurr(const NeuroClientPtrPtr c) {
+  if (!c)
+    return 0;
+  NeuroRenderContext rc;
+  return NeuroClientBorderGapContextSetterCurr(c, NeuroClientGetRenderContext(&rc, NEURO_CLIENT_PTR(c)->ws));
+}
+
+// Color Context Setters
+NeuroColor NeuroClientColorContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  (void)rc;
+  if (!c)
+    return NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
 
   return NeuroCoreClientIsCurr(c) ? NeuroSystemGetColor(NEURO_SYSTEM_COLOR_CURRENT) :
       NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
 }
 
-NeuroColor NeuroClientColorSetterAll(const NeuroClientPtrPtr c) {
+NeuroColor NeuroClientColorContextSetterAll(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  (void)rc;
   if (!c)
-    NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
+    return NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
 
   if (NeuroCoreClientIsCurr(c))
     return NeuroSystemGetColor(NEURO_SYSTEM_COLOR_CURRENT);
@@ -583,23 +1268,27 @@ NeuroColor NeuroClientColorSetterAll(const NeuroClientPtrPtr c) {
       NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
 }
 
-NeuroColor NeuroClientColorSetterNone(const NeuroClientPtrPtr c) {
+NeuroColor NeuroClientColorContextSetterNone(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
   (void)c;
+  (void)rc;
   return NeuroSystemGetColor(NEURO_SYSTEM_COLOR_NORMAL);
 }
 
-// Border Width Setters
-int NeuroClientBorderWidthSetterAlways(const NeuroClientPtrPtr c) {
+// Border Width Context Setters
+int NeuroClientBorderWidthContextSetterAlways(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
   (void)c;
-  return NeuroConfigGet()->border_width;
+  assert(rc);
+  return rc->border_width;
 }
 
-int NeuroClientBorderWidthSetterNever(const NeuroClientPtrPtr c) {
+int NeuroClientBorderWidthContextSetterNever(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
   (void)c;
+  (void)rc;
   return 0;
 }
 
-int NeuroClientBorderWidthSetterSmart(const NeuroClientPtrPtr c) {
+int NeuroClientBorderWidthContextSetterSmart(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  assert(rc);
   if (!c)
     return 0;
 
@@ -608,103 +1297,60 @@ int NeuroClientBorderWidthSetterSmart(const NeuroClientPtrPtr c) {
   if (client->is_fullscreen)
     return 0;
 
-  // Border if free
-  if (client->free_setter_fn != NeuroRuleFreeSetterNull)
-    return NeuroConfigGet()->border_width;
-
-  // Border if float layout
-  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
-  if (l->arranger_fn == NeuroLayoutArrangerFloat)
-    return NeuroConfigGet()->border_width;
-
-  // Border if workspace has a fixed client
-  if (NeuroWorkspaceClientFindFixed(client->ws))
-    return NeuroConfigGet()->border_width;
-
-  // No border if the client fits all stack region
-  const NeuroRectangle *const rc = NeuroCoreClientGetRegion(c);
-  const NeuroRectangle *const rs = NeuroCoreStackGetRegion(client->ws);
-  if ((rc->w == rs->w && rc->h == rs->h) ||
-      (rc->w == NeuroSystemGetScreenRegion()->w && rc->h == NeuroSystemGetScreenRegion()->h))
-    return 0;
+  // Border if free, float layout or workspace has a fixed client
+  if (client->free_setter_fn != NeuroRuleFreeSetterNull || rc->is_float_layout || rc->has_fixed_client)
+    return rc->border_width;
 
-  // Border otherwise
-  return NeuroConfigGet()->border_width;
+  // No border if the client fits all stack region, border otherwise
+  return fills_region(NeuroCoreClientGetRegion(c), rc) ? 0 : rc->border_width;
 }
 
-int NeuroClientBorderWidthSetterCurr(const NeuroClientPtrPtr c) {
+int NeuroClientBorderWidthContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  assert(rc);
   if (!c)
     return 0;
-  return NeuroCoreClientIsCurr(c) ? NeuroConfigGet()->border_width : 0;
+  return NeuroCoreClientIsCurr(c) ? rc->border_width : 0;
 }
 
-// Border Gap Setters
-int NeuroClientBorderGapSetterAlways(const NeuroClientPtrPtr c) {
+// Border Gap Context Setters
+int NeuroClientBorderGapContextSetterAlways(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  assert(rc);
   if (!c)
     return 0;
 
-  // No gap if client is free
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  if (client->free_setter_fn != NeuroRuleFreeSetterNull)
-    return 0;
-
-  // No gap if float layout
-  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
-  if (client->is_fullscreen || client->free_setter_fn != NeuroRuleFreeSetterNull ||
-      l->arranger_fn == NeuroLayoutArrangerFloat)
-    return 0;
-
-  // Gap otherwise
-  return NeuroConfigGet()->border_gap;
+  // No gap if client is fullscreen, free or float layout, gap otherwise
+  return has_no_gap(NEURO_CLIENT_PTR(c), rc) ? 0 : rc->border_gap;
 }
 
-int NeuroClientBorderGapSetterNever(const NeuroClientPtrPtr c) {
+int NeuroClientBorderGapContextSetterNever(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
   (void)c;
+  (void)rc;
   return 0;
 }
 
-int NeuroClientBorderGapSetterSmart(const NeuroClientPtrPtr c) {
+int NeuroClientBorderGapContextSetterSmart(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  assert(rc);
   if (!c)
     return 0;
 
-  // No gap if client is free
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  if (client->free_setter_fn != NeuroRuleFreeSetterNull)
-    return 0;
-
-  // No gap if float layout
-  const NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
-  if (client->is_fullscreen || client->free_setter_fn != NeuroRuleFreeSetterNull ||
-      l->arranger_fn == NeuroLayoutArrangerFloat)
-    return 0;
-
-  // No gapr if the client fits all stack region
-  const NeuroRectangle *const a = NeuroCoreClientGetRegion(c);
-  const NeuroRectangle *const as = NeuroCoreStackGetRegion(client->ws);
-  if ((a->w == as->w && a->h == as->h) ||
-      (a->w == NeuroSystemGetScreenRegion()->w && a->h == NeuroSystemGetScreenRegion()->h))
+  // No gap if client is fullscreen, free or float layout
+  if (has_no_gap(NEURO_CLIENT_PTR(c), rc))
     return 0;
 
-  // Gap otherwise
-  return NeuroConfigGet()->border_gap;
+  // No gap if the client fits all stack region, gap otherwise
+  return fills_region(NeuroCoreClientGetRegion(c), rc) ? 0 : rc->border_gap;
 }
 
-int NeuroClientBorderGapSetterCurr(const NeuroClientPtrPtr c) {
+int NeuroClientBorderGapContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc) {
+  assert(rc);
   if (!c)
     return 0;
 
-  // No gap if client is free
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  if (client->free_setter_fn != NeuroRuleFreeSetterNull)
-    return 0;
-
-  // No gap if float layout
-  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
-  if (client->is_fullscreen || client->free_setter_fn != NeuroRuleFreeSetterNull ||
-      l->arranger_fn == NeuroLayoutArrangerFloat)
+  // No gap if client is fullscreen, free or float layout
+  if (has_no_gap(NEURO_CLIENT_PTR(c), rc))
     return 0;
 
   // Gap if current, no gap otherwise
-  return NeuroCoreClientIsCurr(c) ? NeuroConfigGet()->border_gap : 0;
+  return NeuroCoreClientIsCurr(c) ? rc->border_gap : 0;
 }
 
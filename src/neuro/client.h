@@ -21,10 +21,31 @@
 // FUNCTION DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Update queue
+bool NeuroClientInit(void);
+void NeuroClientStop(void);
+void NeuroClientFlushUpdates(void);
+void NeuroClientResetShadow(NeuroClientPtrPtr c);
+NeuroIndex NeuroClientGetEmittedRequests(void);
+NeuroIndex NeuroClientGetSuppressedRequests(void);
+void NeuroClientBeginTransaction(void);
+void NeuroClientEndTransaction(void);
+bool NeuroClientIsInTransaction(void);
+
+// Render Context
+NeuroRenderContext *NeuroClientGetRenderContext(NeuroRenderContext *dst, NeuroIndex ws);
+
 // Basic Functions
 void NeuroClientUpdate(NeuroClientPtrPtr c, const void *data);
+void NeuroClientUpdateWithContext(NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+void NeuroClientConfigure(NeuroClientPtrPtr c, const XConfigureRequestEvent *ev);
+bool NeuroClientRequestRegion(NeuroClientPtrPtr c, const XConfigureRequestEvent *ev, const NeuroRenderContext *rc);
+void NeuroClientApplyConfigureRequest(NeuroRectangle *dst, const XConfigureRequestEvent *ev,
+    const NeuroClientInfo *info);
 void NeuroClientUpdateClassAndName(NeuroClientPtrPtr c, const void *data);
 void NeuroClientUpdateTitle(NeuroClientPtrPtr c, const void *data);
+void NeuroClientSetClassAndName(NeuroClientPtrPtr c, const char *class, const char *name);
+void NeuroClientSetTitle(NeuroClientPtrPtr c, const XTextProperty *tp);
 void NeuroClientSetUrgent(NeuroClientPtrPtr c, const void *data);
 void NeuroClientUnsetUrgent(NeuroClientPtrPtr c, const void *data);
 void NeuroClientKill(NeuroClientPtrPtr c, const void *data);
@@ -88,3 +109,20 @@ int NeuroClientBorderGapSetterNever(const NeuroClientPtrPtr c);
 int NeuroClientBorderGapSetterSmart(const NeuroClientPtrPtr c);
 int NeuroClientBorderGapSetterCurr(const NeuroClientPtrPtr c);
 
+// Color Context Setters
+NeuroColor NeuroClientColorContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+NeuroColor NeuroClientColorContextSetterAll(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+NeuroColor NeuroClientColorContextSetterNone(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+
+// Border Width Context Setters
+int NeuroClientBorderWidthContextSetterAlways(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderWidthContextSetterNever(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderWidthContextSetterSmart(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderWidthContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+
+// Border Gap Context Setters
+int NeuroClientBorderGapContextSetterAlways(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderGapContextSetterNever(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderGapContextSetterSmart(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+int NeuroClientBorderGapContextSetterCurr(const NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+
@@ -464,7 +464,12 @@ static const NeuroConfiguration default_ = {
   NeuroConfigDefaultWorkspaceList,
   NEURO_CONFIG_DEFAULT_RULE_LIST,
   NeuroConfigDefaultKeyList,
-  NeuroConfigDefaultButtonList
+  NeuroConfigDefaultButtonList,
+  NEURO_CONFIG_DEFAULT_MAX_BATCH_LATENCY,
+  NEURO_CONFIG_DEFAULT_LOOP_MODE,
+  NEURO_CONFIG_DEFAULT_MOTION_RATE,
+  NEURO_CONFIG_DEFAULT_HIDE_MODE,
+  NEURO_CONFIG_DEFAULT_MAX_GRAB_TIME
 };
 
 // Main configuration
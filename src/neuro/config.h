@@ -27,6 +27,11 @@
 #define NEURO_CONFIG_DEFAULT_BORDER_WIDTH 1
 #define NEURO_CONFIG_DEFAULT_BORDER_GAP 0
 #define NEURO_CONFIG_DEFAULT_RULE_LIST NULL
+#define NEURO_CONFIG_DEFAULT_MAX_BATCH_LATENCY 10
+#define NEURO_CONFIG_DEFAULT_LOOP_MODE NEURO_LOOP_MODE_EPOLL
+#define NEURO_CONFIG_DEFAULT_MOTION_RATE 60
+#define NEURO_CONFIG_DEFAULT_HIDE_MODE NEURO_HIDE_MODE_UNMAP
+#define NEURO_CONFIG_DEFAULT_MAX_GRAB_TIME 0
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -17,34 +17,60 @@
 #include "config.h"
 #include "geometry.h"
 #include "monitor.h"
+#include "rule.h"
 
 // Defines
 #define STEP_SIZE_REALLOC 32
+#define WINDOW_INDEX_MIN_BITS 6  // 64 slots
+#define WINDOW_INDEX_HASH_MULT 11400714819323198485ULL  // 2^64 / golden ratio
+#define POOL_SLOTS_PER_STACK 8  // Slots reserved for each workspace on every pool chunk
+#define POOL_MIN_CHUNK_SLOTS 32
+#define POOL_CHUNK_ALIGNMENT 64  // Cache line size, chunks start on a line so client slots never straddle two
+#define INTERN_TABLE_MIN_BITS 6  // 64 slots
+#define INTERN_HASH_OFFSET 14695981039346656037ULL  // FNV-1a 64 bit offset basis
+#define INTERN_HASH_PRIME 1099511628211ULL  // FNV-1a 64 bit prime
+#define NODE_INVALID_INDEX ((NeuroIndex)-1)
+#define NODE_FLAG(a) ((uint8_t)(1U << (a)))
 
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
-// Node
+// Node (stable handle of a stack position, NeuroClientPtrPtr points to it)
 typedef struct Node Node;
 struct Node {
-  NeuroClient *cli;
-  Node *next;
-  Node *prev;
-  NeuroRectangle region;
+  NeuroClient *cli;  // Must be the first member so that NEURO_CLIENT_PTR works
+  NeuroIndex ws;     // Stack the node belongs to
+  NeuroIndex idx;    // Position of the node in the stack arrays, NODE_INVALID_INDEX if released
+  Node *attr_next[ NEURO_CORE_ATTRIBUTE_END ];  // Intrusive lists of the nodes sharing an attribute
+  Node *attr_prev[ NEURO_CORE_ATTRIBUTE_END ];
 };
 
-// Stack
+// Stack (clients are stored by position in parallel arrays)
 typedef struct Stack Stack;
 struct Stack {
   const char *name;
   Node *curr;
   Node *prev;  // Previous selected node
-  Node *head;
-  Node *last;
-  Node *nsp;
   NeuroIndex size;  // Number of clients the stack has
+  NeuroIndex capacity;  // Allocated size of the parallel arrays
+  Node **nodes;
+  Window *wins;
+  NeuroRectangle *regions;
+  uint8_t *flags;  // Attributes of each client, see NODE_FLAG
+  Node *attr_head[ NEURO_CORE_ATTRIBUTE_END ];
+  NeuroIndex attr_num[ NEURO_CORE_ATTRIBUTE_END ];
+  NeuroIndex generation;  // Bumped by every change that can modify the geometry of the stack
+  NeuroIndex arranged_generation;  // Generation of the last arrange
+  const NeuroLayout *arranged_layout;  // Layout of the last arrange
+  NeuroIndex updated_generation;  // Generation of the last update
+  bool is_relayout_pending;  // The stack must be arranged, updated and focused at the end of the event batch
+  bool is_stacking_known;  // The server stacking order matches the client stack stamps, false after adding clients
+  NeuroArrange arrange;  // Arrange workspace reused by every layout run
+  NeuroDenseArrange dense_arrange;  // Dense arrange workspace, its coordinates live in arrange_coords
+  int *arrange_coords;  // Storage of the x, y, w and h arrays of the dense arrange
+  NeuroIndex arrange_capacity;  // Allocated size of the arrange arrays
   const NeuroMonitor *monitor;
   const int *gaps;
   NeuroRectangle region;
@@ -60,6 +86,54 @@ struct Stack {
   NeuroIndex minimized_size;  // Allocated size
 };
 
+// WindowEntry
+typedef struct WindowEntry WindowEntry;
+struct WindowEntry {
+  Window win;        // Key of the entry, None if the slot is empty
+  Node *node;        // Node of the client, NULL if the client is minimized
+  NeuroClient *cli;  // Client that owns the window
+};
+
+// WindowIndex (open addressing hash table with linear probing)
+typedef struct WindowIndex WindowIndex;
+struct WindowIndex {
+  WindowEntry *entries;
+  NeuroIndex size;   // Allocated slots, always a power of 2
+  NeuroIndex count;  // Number of used slots
+  NeuroIndex bits;   // log2(size)
+};
+
+// PoolSlot (free slots are chained through their own storage)
+typedef struct PoolSlot PoolSlot;
+struct PoolSlot {
+  PoolSlot *next;
+};
+
+// Pool (the first slot of every chunk links the chunk list, the rest are handed out)
+typedef struct Pool Pool;
+struct Pool {
+  const size_t slot_size;
+  NeuroIndex chunk_slots;  // Number of usable slots of every new chunk
+  PoolSlot *chunks;
+  PoolSlot *free_slots;
+  NeuroPoolStats stats;
+};
+
+// InternEntry
+typedef struct InternEntry InternEntry;
+struct InternEntry {
+  char *str;  // NULL if the slot is empty
+  uint64_t hash;
+};
+
+// InternTable (open addressing hash table with linear probing, strings are never removed)
+typedef struct InternTable InternTable;
+struct InternTable {
+  InternEntry *entries;
+  NeuroIndex size;   // Allocated slots, always a power of 2
+  NeuroIndex count;  // Number of used slots
+};
+
 // StackSet
 typedef struct StackSet StackSet;
 struct StackSet {
@@ -67,6 +141,7 @@ struct StackSet {
   NeuroIndex curr;
   NeuroIndex old;  // Previouse selected workspace
   NeuroIndex size;  // Number of stacks the stackset has
+  WindowIndex window_index;  // Maps every managed window to its client
 };
 
 
@@ -77,91 +152,523 @@ struct StackSet {
 // StackSet
 static StackSet stack_set_;
 
+// Pools
+static Pool node_pool_ = { .slot_size = sizeof(Node), .chunk_slots = POOL_MIN_CHUNK_SLOTS };
+static Pool client_pool_ = { .slot_size = POOL_CHUNK_ALIGNMENT, .chunk_slots = POOL_MIN_CHUNK_SLOTS };
+static Pool client_info_pool_ = { .slot_size = sizeof(NeuroClientInfo), .chunk_slots = POOL_MIN_CHUNK_SLOTS };
+
+// Interned strings
+static InternTable intern_table_;
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static void update_nsp_stack(Stack *s) {
-  assert(s);
-  for (Node *n = s->head; n; n = n->next)
-    if (n->cli->is_nsp) {
-      s->nsp = n;
-      return;
+// Pool
+static bool grow_pool(Pool *p) {
+  assert(p);
+  const size_t size = (p->chunk_slots + 1U)*p->slot_size;
+  unsigned char *const chunk = (unsigned char *)aligned_alloc(POOL_CHUNK_ALIGNMENT,
+      (size + POOL_CHUNK_ALIGNMENT - 1U)/POOL_CHUNK_ALIGNMENT*POOL_CHUNK_ALIGNMENT);
+  if (!chunk)
+    return false;
+  PoolSlot *const head = (PoolSlot *)chunk;
+  head->next = p->chunks;
+  p->chunks = head;
+  for (NeuroIndex i = p->chunk_slots; i > 0U; --i) {
+    PoolSlot *const slot = (PoolSlot *)(chunk + i*p->slot_size);
+    slot->next = p->free_slots;
+    p->free_slots = slot;
+  }
+  p->stats.capacity += p->chunk_slots;
+  p->stats.heap_allocs++;
+  return true;
+}
+
+static bool init_pool(Pool *p, NeuroIndex chunk_slots) {
+  assert(p);
+  p->chunk_slots = chunk_slots < POOL_MIN_CHUNK_SLOTS ? POOL_MIN_CHUNK_SLOTS : chunk_slots;
+  return p->free_slots || grow_pool(p);
+}
+
+static void stop_pool(Pool *p) {
+  assert(p);
+  PoolSlot *chunk = p->chunks;
+  while (chunk) {
+    PoolSlot *const next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  p->chunks = NULL;
+  p->free_slots = NULL;
+  memset(&p->stats, 0, sizeof(NeuroPoolStats));
+}
+
+static void *alloc_pool_slot(Pool *p) {
+  assert(p);
+  if (!p->free_slots && !grow_pool(p))
+    return NULL;
+  PoolSlot *const slot = p->free_slots;
+  p->free_slots = slot->next;
+  p->stats.used++;
+  p->stats.allocs++;
+  return slot;
+}
+
+static void free_pool_slot(Pool *p, void *ptr) {
+  assert(p);
+  if (!ptr)
+    return;
+  PoolSlot *const slot = (PoolSlot *)ptr;
+  slot->next = p->free_slots;
+  p->free_slots = slot;
+  p->stats.used--;
+}
+
+// Intern Table
+static uint64_t hash_string(const char *str) {
+  assert(str);
+  uint64_t hash = INTERN_HASH_OFFSET;
+  for (const unsigned char *p = (const unsigned char *)str; *p; ++p)
+    hash = (hash ^ *p)*INTERN_HASH_PRIME;
+  return hash;
+}
+
+static bool init_intern_table(InternTable *it, NeuroIndex size) {
+  assert(it);
+  it->entries = (InternEntry *)calloc(size, sizeof(InternEntry));
+  if (!it->entries)
+    return false;
+  it->size = size;
+  it->count = 0U;
+  return true;
+}
+
+static void put_intern_entry(InternTable *it, char *str, uint64_t hash) {
+  assert(it);
+  const NeuroIndex mask = it->size - 1U;
+  NeuroIndex i = (NeuroIndex)hash & mask;
+  while (it->entries[ i ].str)
+    i = (i + 1U) & mask;
+  it->entries[ i ].str = str;
+  it->entries[ i ].hash = hash;
+  it->count++;
+}
+
+static bool grow_intern_table(InternTable *it) {
+  assert(it);
+  InternTable new_it;
+  if (!init_intern_table(&new_it, 2U*it->size))
+    return false;
+  for (NeuroIndex i = 0U; i < it->size; ++i)
+    if (it->entries[ i ].str)
+      put_intern_entry(&new_it, it->entries[ i ].str, it->entries[ i ].hash);
+  free(it->entries);
+  *it = new_it;
+  return true;
+}
+
+static void stop_intern_table(InternTable *it) {
+  assert(it);
+  for (NeuroIndex i = 0U; i < it->size; ++i)
+    free(it->entries[ i ].str);
+  free(it->entries);
+  it->entries = NULL;
+  it->size = 0U;
+  it->count = 0U;
+}
+
+static const char *intern_string(InternTable *it, const char *str) {
+  assert(it);
+  assert(str);
+  if (!it->entries && !init_intern_table(it, (NeuroIndex)1U << INTERN_TABLE_MIN_BITS))
+    return NULL;
+
+  // Return the stored copy if the string was already interned
+  const uint64_t hash = hash_string(str);
+  const NeuroIndex mask = it->size - 1U;
+  for (NeuroIndex i = (NeuroIndex)hash & mask; it->entries[ i ].str; i = (i + 1U) & mask)
+    if (it->entries[ i ].hash == hash && !strcmp(it->entries[ i ].str, str))
+      return it->entries[ i ].str;
+
+  // Store a new copy otherwise
+  if (2U*(it->count + 1U) > it->size && !grow_intern_table(it))
+    return NULL;
+  const size_t len = strlen(str) + 1U;
+  char *const copy = (char *)malloc(len);
+  if (!copy)
+    return NULL;
+  memmove(copy, str, len);
+  put_intern_entry(it, copy, hash);
+  return copy;
+}
+
+// Window Index
+static NeuroIndex hash_window(const WindowIndex *wi, Window w) {
+  assert(wi);
+  return (NeuroIndex)(((uint64_t)w * WINDOW_INDEX_HASH_MULT) >> (64U - wi->bits));
+}
+
+static bool init_window_index(WindowIndex *wi, NeuroIndex bits) {
+  assert(wi);
+  wi->entries = (WindowEntry *)calloc((NeuroIndex)1U << bits, sizeof(WindowEntry));
+  if (!wi->entries)
+    return false;
+  wi->size = (NeuroIndex)1U << bits;
+  wi->count = 0U;
+  wi->bits = bits;
+  return true;
+}
+
+static void stop_window_index(WindowIndex *wi) {
+  assert(wi);
+  free(wi->entries);
+  wi->entries = NULL;
+  wi->size = 0U;
+  wi->count = 0U;
+  wi->bits = 0U;
+}
+
+static WindowEntry *find_window_entry(const WindowIndex *wi, Window w) {
+  assert(wi);
+  if (w == None || !wi->entries)
+    return NULL;
+  const NeuroIndex mask = wi->size - 1U;
+  for (NeuroIndex i = hash_window(wi, w); wi->entries[ i ].win != None; i = (i + 1U) & mask)
+    if (wi->entries[ i ].win == w)
+      return wi->entries + i;
+  return NULL;
+}
+
+static void put_window_entry(WindowIndex *wi, Window w, Node *n, NeuroClient *c) {
+  assert(wi);
+  const NeuroIndex mask = wi->size - 1U;
+  NeuroIndex i = hash_window(wi, w);
+  while (wi->entries[ i ].win != None && wi->entries[ i ].win != w)
+    i = (i + 1U) & mask;
+  if (wi->entries[ i ].win == None)
+    wi->count++;
+  wi->entries[ i ].win = w;
+  wi->entries[ i ].node = n;
+  wi->entries[ i ].cli = c;
+}
+
+static bool grow_window_index(WindowIndex *wi) {
+  assert(wi);
+  WindowIndex new_wi;
+  if (!init_window_index(&new_wi, wi->bits + 1U))
+    return false;
+  for (NeuroIndex i = 0U; i < wi->size; ++i) {
+    const WindowEntry *const e = wi->entries + i;
+    if (e->win != None)
+      put_window_entry(&new_wi, e->win, e->node, e->cli);
+  }
+  stop_window_index(wi);
+  *wi = new_wi;
+  return true;
+}
+
+// Note: Windows with None ID are never indexed
+static bool set_window_entry(WindowIndex *wi, Window w, Node *n, NeuroClient *c) {
+  assert(wi);
+  if (w == None)
+    return true;
+  WindowEntry *const e = find_window_entry(wi, w);
+  if (e) {
+    e->node = n;
+    e->cli = c;
+    return true;
+  }
+  if (2U*(wi->count + 1U) > wi->size && !grow_window_index(wi))
+    return false;
+  put_window_entry(wi, w, n, c);
+  return true;
+}
+
+// Backward shift deletion, so that no tombstones are needed
+static void remove_window_entry(WindowIndex *wi, Window w) {
+  assert(wi);
+  WindowEntry *const e = find_window_entry(wi, w);
+  if (!e)
+    return;
+  const NeuroIndex mask = wi->size - 1U;
+  NeuroIndex hole = (NeuroIndex)(e - wi->entries);
+  for (NeuroIndex i = (hole + 1U) & mask; wi->entries[ i ].win != None; i = (i + 1U) & mask) {
+    const NeuroIndex home = hash_window(wi, wi->entries[ i ].win);
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      wi->entries[ hole ] = wi->entries[ i ];
+      hole = i;
     }
-  s->nsp = NULL;
+  }
+  wi->entries[ hole ].win = None;
+  wi->entries[ hole ].node = NULL;
+  wi->entries[ hole ].cli = NULL;
+  wi->count--;
+}
+
+// Stack
+static void bump_generation(Stack *s) {
+  assert(s);
+  s->generation++;
+}
+
+static bool is_valid_node(const Node *n) {
+  if (!n || n->ws >= stack_set_.size)
+    return false;
+  const Stack *const s = stack_set_.stack_list + n->ws;
+  return n->idx < s->size && s->nodes[ n->idx ] == n;
+}
+
+static uint8_t get_client_flags(const NeuroClient *c) {
+  assert(c);
+  uint8_t flags = 0U;
+  if (c->is_nsp)
+    flags |= NODE_FLAG(NEURO_CORE_ATTRIBUTE_NSP);
+  if (c->fixed_pos != NEURO_FIXED_POSITION_NULL)
+    flags |= NODE_FLAG(NEURO_CORE_ATTRIBUTE_FIXED);
+  if (c->is_fullscreen)
+    flags |= NODE_FLAG(NEURO_CORE_ATTRIBUTE_FULLSCREEN);
+  if (c->is_urgent)
+    flags |= NODE_FLAG(NEURO_CORE_ATTRIBUTE_URGENT);
+  if (c->free_setter_fn != NeuroRuleFreeSetterNull)
+    flags |= NODE_FLAG(NEURO_CORE_ATTRIBUTE_FREE);
+  return flags;
+}
+
+static void link_attribute(Stack *s, Node *n, NeuroCoreAttribute a) {
+  assert(s);
+  assert(n);
+  Node *const head = s->attr_head[ a ];
+  n->attr_prev[ a ] = NULL;
+  n->attr_next[ a ] = head;
+  if (head)
+    head->attr_prev[ a ] = n;
+  s->attr_head[ a ] = n;
+  s->attr_num[ a ]++;
+}
+
+static void unlink_attribute(Stack *s, Node *n, NeuroCoreAttribute a) {
+  assert(s);
+  assert(n);
+  if (n->attr_prev[ a ])
+    n->attr_prev[ a ]->attr_next[ a ] = n->attr_next[ a ];
+  else
+    s->attr_head[ a ] = n->attr_next[ a ];
+  if (n->attr_next[ a ])
+    n->attr_next[ a ]->attr_prev[ a ] = n->attr_prev[ a ];
+  n->attr_next[ a ] = NULL;
+  n->attr_prev[ a ] = NULL;
+  s->attr_num[ a ]--;
+}
+
+// Links the node in the lists of the attributes its client has, and stores them in the flags array
+static void link_attributes(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  const uint8_t flags = get_client_flags(n->cli);
+  s->flags[ n->idx ] = flags;
+  for (NeuroIndex a = 0U; a < NEURO_CORE_ATTRIBUTE_END; ++a)
+    if (flags & NODE_FLAG(a))
+      link_attribute(s, n, (NeuroCoreAttribute)a);
+}
+
+static void unlink_attributes(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  const uint8_t flags = s->flags[ n->idx ];
+  for (NeuroIndex a = 0U; a < NEURO_CORE_ATTRIBUTE_END; ++a)
+    if (flags & NODE_FLAG(a))
+      unlink_attribute(s, n, (NeuroCoreAttribute)a);
+  s->flags[ n->idx ] = 0U;
+}
+
+static void set_node_attribute(Node *n, NeuroCoreAttribute a, bool on) {
+  assert(is_valid_node(n));
+  Stack *const s = stack_set_.stack_list + n->ws;
+  const bool is_on = (s->flags[ n->idx ] & NODE_FLAG(a)) != 0U;
+  if (on == is_on)
+    return;
+  bump_generation(s);
+  if (on) {
+    s->flags[ n->idx ] |= NODE_FLAG(a);
+    link_attribute(s, n, a);
+  } else {
+    s->flags[ n->idx ] &= (uint8_t)~NODE_FLAG(a);
+    unlink_attribute(s, n, a);
+  }
 }
 
 static Node *new_node(NeuroClient *c) {
   assert(c);
-  Node *const n = (Node *)malloc(sizeof(Node));
+  Node *const n = (Node *)alloc_pool_slot(&node_pool_);
   if (!n)
     return NULL;
   n->cli = (NeuroClient *)c;
-  memmove(&(n->region), &(c->float_region), sizeof(NeuroRectangle));
-  n->next = NULL;
-  n->prev = NULL;
+  n->ws = c->ws;
+  n->idx = NODE_INVALID_INDEX;
   return n;
 }
 
 static void delete_node(Node *n) {
   if (!n)
     return;
-  free(n);
+  n->idx = NODE_INVALID_INDEX;
+  free_pool_slot(&node_pool_, n);
   n = NULL;
 }
 
 static void set_curr_node(Node *n) {
   assert(n);
-  Stack *const s = stack_set_.stack_list + n->cli->ws;
+  Stack *const s = stack_set_.stack_list + n->ws;
   if (n == s->curr)
     return;
   s->prev = s->curr;
   s->curr = n;
 }
 
-static NeuroClient *remove_last_node(Stack *s) {
+static bool reserve_stack(Stack *s, NeuroIndex total) {
   assert(s);
-  if (s->size < 1)
-    return NULL;
-  Node *const t = s->last;
-  const bool update_nsp = t->cli->is_nsp;
-  if (s->size == 1) {
-    s->head = NULL;
-    s->last = NULL;
-    s->curr = NULL;
-  } else {
-    set_curr_node(s->last->prev);
-    s->last->prev->next = NULL;
-    s->last = t->prev;
-  }
-  NeuroClient *const ret = t->cli;
-  delete_node(t);
+  if (total <= s->capacity)
+    return true;
+  NeuroIndex new_capacity = s->capacity > 0U ? s->capacity : STEP_SIZE_REALLOC;
+  while (new_capacity < total)
+    new_capacity *= 2U;
+
+  // Every array keeps its old allocation if a later one fails, so the stack is always consistent
+  Node **const nodes = (Node **)realloc(s->nodes, new_capacity*sizeof(Node *));
+  if (!nodes)
+    return false;
+  s->nodes = nodes;
+  Window *const wins = (Window *)realloc(s->wins, new_capacity*sizeof(Window));
+  if (!wins)
+    return false;
+  s->wins = wins;
+  NeuroRectangle *const regions = (NeuroRectangle *)realloc(s->regions, new_capacity*sizeof(NeuroRectangle));
+  if (!regions)
+    return false;
+  s->regions = regions;
+  uint8_t *const flags = (uint8_t *)realloc(s->flags, new_capacity*sizeof(uint8_t));
+  if (!flags)
+    return false;
+  s->flags = flags;
+  s->capacity = new_capacity;
+  return true;
+}
+
+// Note: the arrange workspace only grows, so steady state layout runs do not allocate
+static bool reserve_arrange(Stack *s, NeuroIndex total) {
+  assert(s);
+  if (total <= s->arrange_capacity)
+    return true;
+  NeuroIndex new_capacity = s->arrange_capacity > 0U ? s->arrange_capacity : STEP_SIZE_REALLOC;
+  while (new_capacity < total)
+    new_capacity *= 2U;
+
+  // The contents are rebuilt on every layout run, so they do not need to be kept
+  NeuroRectangle **const rs = (NeuroRectangle **)realloc(s->arrange.client_regions, new_capacity*sizeof(void *));
+  if (!rs)
+    return false;
+  s->arrange.client_regions = rs;
+  NeuroRectangle **const frs = (NeuroRectangle **)realloc(s->arrange.client_float_regions,
+      new_capacity*sizeof(void *));
+  if (!frs)
+    return false;
+  s->arrange.client_float_regions = frs;
+  int *const coords = (int *)realloc(s->arrange_coords, 4U*new_capacity*sizeof(int));
+  if (!coords)
+    return false;
+  s->arrange_coords = coords;
+  s->arrange_capacity = new_capacity;
+  return true;
+}
+
+static void reindex_stack(Stack *s, NeuroIndex from, NeuroIndex to) {
+  assert(s);
+  for (NeuroIndex i = from; i < to; ++i)
+    s->nodes[ i ]->idx = i;
+}
+
+// Note: the stack must have room for the new node (see reserve_stack)
+static void insert_node(Stack *s, Node *n, NeuroIndex pos) {
+  assert(s);
+  assert(n);
+  assert(s->size < s->capacity);
+  assert(pos <= s->size);
+  const NeuroIndex tail = s->size - pos;
+  memmove(s->nodes + pos + 1U, s->nodes + pos, tail*sizeof(Node *));
+  memmove(s->wins + pos + 1U, s->wins + pos, tail*sizeof(Window));
+  memmove(s->regions + pos + 1U, s->regions + pos, tail*sizeof(NeuroRectangle));
+  memmove(s->flags + pos + 1U, s->flags + pos, tail*sizeof(uint8_t));
+  s->nodes[ pos ] = n;
+  s->wins[ pos ] = n->cli->win;
+  memmove(s->regions + pos, &n->cli->float_region, sizeof(NeuroRectangle));
+  s->size++;
+  n->ws = (NeuroIndex)(s - stack_set_.stack_list);
+  reindex_stack(s, pos, s->size);
+  link_attributes(s, n);
+  bump_generation(s);
+}
+
+static void erase_node(Stack *s, Node *n) {
+  assert(s);
+  assert(is_valid_node(n));
+  unlink_attributes(s, n);
+  const NeuroIndex pos = n->idx;
+  const NeuroIndex tail = s->size - pos - 1U;
+  memmove(s->nodes + pos, s->nodes + pos + 1U, tail*sizeof(Node *));
+  memmove(s->wins + pos, s->wins + pos + 1U, tail*sizeof(Window));
+  memmove(s->regions + pos, s->regions + pos + 1U, tail*sizeof(NeuroRectangle));
+  memmove(s->flags + pos, s->flags + pos + 1U, tail*sizeof(uint8_t));
   s->size--;
-  if (update_nsp)
-    update_nsp_stack(s);
-  return ret;
+  n->idx = NODE_INVALID_INDEX;
+  reindex_stack(s, pos, s->size);
+  bump_generation(s);
 }
 
-static NeuroClient *remove_no_last_node(Node *n) {
+// Inserts the node after the current one
+static bool link_node_end(Stack *s, Node *n) {
+  assert(s);
   assert(n);
-  Stack *const s = stack_set_.stack_list + n->cli->ws;
-  if (s->size == 0U || s->last == n)
-    return NULL;
-  const bool update_nsp = n->cli->is_nsp;
-  set_curr_node(n->next);
-  if (n == s->head) {
-    s->head = n->next;
-    n->next->prev = NULL;
-  } else {
-    n->prev->next = n->next;
-    n->next->prev = n->prev;
-  }
+  if (!reserve_stack(s, s->size + 1U))
+    return false;
+  insert_node(s, n, s->curr ? s->curr->idx + 1U : 0U);
+  set_curr_node(n);
+  return true;
+}
+
+// Inserts the node before the current one
+static bool link_node_start(Stack *s, Node *n) {
+  assert(s);
+  assert(n);
+  if (!reserve_stack(s, s->size + 1U))
+    return false;
+  insert_node(s, n, s->curr ? s->curr->idx : 0U);
+  set_curr_node(n);
+  return true;
+}
+
+// Note: the node is detached from the stack but not freed, so that it can be deleted or linked into another stack
+static void unlink_node(Stack *s, Node *n) {
+  assert(s);
+  assert(is_valid_node(n));
+  if (s->size == 1U)
+    s->curr = NULL;
+  else
+    set_curr_node(s->nodes[ n->idx == s->size - 1U ? n->idx - 1U : n->idx + 1U ]);
+  if (s->prev == n)
+    s->prev = NULL;
+  erase_node(s, n);
+}
+
+static NeuroClient *remove_node(Stack *s, Node *n) {
+  assert(s);
+  if (!n || s->size < 1)
+    return NULL;
+  unlink_node(s, n);
   NeuroClient *const ret = n->cli;
+  remove_window_entry(&stack_set_.window_index, ret->win);
   delete_node(n);
-  s->size--;
-  if (update_nsp)
-    update_nsp_stack(s);
   return ret;
 }
 
@@ -193,6 +700,10 @@ static NeuroClient *push_minimized_client(Stack *s, NeuroClient *c) {
   if (!update_minimized_clients_size(s, new_total))
     return NULL;
 
+  // Index the client as minimized
+  if (!set_window_entry(&stack_set_.window_index, c->win, NULL, c))
+    return NULL;
+
   // Store the client
   s->num_minimized = new_total;
   s->minimized_clients[ new_total - 1 ] = c;
@@ -210,23 +721,26 @@ static NeuroClient *pop_minimized_client(Stack *s) {
 
   NeuroClient *const cli = s->minimized_clients[ new_count ];
   s->num_minimized = new_count;
+  remove_window_entry(&stack_set_.window_index, cli->win);
   return cli;
 }
 
-static NeuroClient *remove_minimized_client(Stack *s, Window w) {
-  if (!s)
+static NeuroClient *remove_minimized_client(Stack *s, const NeuroClient *c) {
+  if (!s || !c)
     return NULL;
 
   NeuroClient *found = NULL;
   for (NeuroIndex i = 0U; i < s->num_minimized; ++i) {
-    NeuroClient *const c = s->minimized_clients[ i ];
+    NeuroClient *const mc = s->minimized_clients[ i ];
     if (found)
-      s->minimized_clients[ i-1 ] = c;
-    if (c->win == w)
-      found = c;
+      s->minimized_clients[ i-1 ] = mc;
+    if (mc == c)
+      found = mc;
   }
-  if (found)
+  if (found) {
     s->num_minimized--;
+    remove_window_entry(&stack_set_.window_index, found->win);
+  }
   return found;
 }
 
@@ -238,13 +752,18 @@ static void set_layouts(NeuroLayout *layout, const NeuroLayoutConf *const *layou
     NeuroLayout *const l = layout + i;
     const NeuroLayoutConf *const lc = layout_conf[ i ];
     l->arranger_fn = lc->arranger_fn;
+    l->dense_arranger_fn = lc->dense_arranger_fn;
     l->border_color_setter_fn = lc->border_color_setter_fn;
     l->border_width_setter_fn = lc->border_width_setter_fn;
     l->border_gap_setter_fn = lc->border_gap_setter_fn;
+    l->border_color_context_setter_fn = lc->border_color_context_setter_fn;
+    l->border_width_context_setter_fn = lc->border_width_context_setter_fn;
+    l->border_gap_context_setter_fn = lc->border_gap_context_setter_fn;
     l->region = lc->region;
     l->mod = lc->mod;
     l->follow_mouse = lc->follow_mouse;
     memmove(l->parameters, lc->parameters, sizeof(NeuroArg)*NEURO_ARRANGE_ARGS_MAX);
+    NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
   }
 }
 
@@ -274,10 +793,23 @@ static bool init_stack(Stack *s, const char *name, const NeuroLayoutConf *const
   // Set clients
   s->curr = NULL;
   s->prev = NULL;
-  s->head = NULL;
-  s->last = NULL;
-  s->nsp = NULL;
   s->size = 0;
+  s->generation = 1U;  // Stacks start dirty, so that the first arrange and update always run
+  s->arranged_generation = 0U;
+  s->arranged_layout = NULL;
+  s->updated_generation = 0U;
+  s->is_relayout_pending = false;
+  s->is_stacking_known = false;
+  s->arrange.client_regions = NULL;
+  s->arrange.client_float_regions = NULL;
+  s->arrange_coords = NULL;
+  s->arrange_capacity = 0U;
+  for (NeuroIndex a = 0U; a < NEURO_CORE_ATTRIBUTE_END; ++a) {
+    s->attr_head[ a ] = NULL;
+    s->attr_num[ a ] = 0U;
+  }
+  if (!reserve_stack(s, STEP_SIZE_REALLOC))
+    return false;
   s->num_minimized = 0;
   s->minimized_size = STEP_SIZE_REALLOC;
 
@@ -302,8 +834,26 @@ static void stop_stack(Stack *s) {
 
   // Remove clients
   NeuroClient *c = NULL;
-  while ((c = remove_last_node(s)))
+  while (s->size > 0U && (c = remove_node(s, s->nodes[ s->size - 1U ])))
     NeuroTypeDeleteClient(c);
+  free(s->nodes);
+  s->nodes = NULL;
+  free(s->wins);
+  s->wins = NULL;
+  free(s->regions);
+  s->regions = NULL;
+  free(s->flags);
+  s->flags = NULL;
+  s->capacity = 0U;
+
+  // Remove the arrange workspace
+  free(s->arrange.client_regions);
+  s->arrange.client_regions = NULL;
+  free(s->arrange.client_float_regions);
+  s->arrange.client_float_regions = NULL;
+  free(s->arrange_coords);
+  s->arrange_coords = NULL;
+  s->arrange_capacity = 0U;
 
   // Remove minimized clients
   while ((c = pop_minimized_client(s)))
@@ -347,6 +897,15 @@ bool NeuroCoreInit(void) {
   if (!stack_set_.stack_list)
     return false;
 
+  // Allocate the window index
+  if (!init_window_index(&stack_set_.window_index, WINDOW_INDEX_MIN_BITS))
+    return false;
+
+  // Reserve the node and client pools
+  if (!init_pool(&node_pool_, size*POOL_SLOTS_PER_STACK) || !init_pool(&client_pool_, size*POOL_SLOTS_PER_STACK) ||
+      !init_pool(&client_info_pool_, size*POOL_SLOTS_PER_STACK))
+    return false;
+
   // Initialize the stack set
   stack_set_.curr = 0U;
   stack_set_.old = 0U;
@@ -379,6 +938,52 @@ void NeuroCoreStop(void) {
   // Remove the stack list
   delete_stack_list(stack_set_.stack_list);
   stack_set_.stack_list = NULL;
+
+  // Remove the window index
+  stop_window_index(&stack_set_.window_index);
+
+  // Release the node and client pools
+  stop_pool(&node_pool_);
+  stop_pool(&client_pool_);
+  stop_pool(&client_info_pool_);
+
+  // Release the interned strings
+  stop_intern_table(&intern_table_);
+}
+
+const NeuroPoolStats *NeuroCoreGetNodePoolStats(void) {
+  return &node_pool_.stats;
+}
+
+const NeuroPoolStats *NeuroCoreGetClientPoolStats(void) {
+  return &client_pool_.stats;
+}
+
+// Note: hot and cold client records come from different pools, so that the hot ones are packed together
+NeuroClient *NeuroCoreAllocClient(void) {
+  NeuroClient *const c = (NeuroClient *)alloc_pool_slot(&client_pool_);
+  if (!c)
+    return NULL;
+  c->info = (NeuroClientInfo *)alloc_pool_slot(&client_info_pool_);
+  if (!c->info) {
+    free_pool_slot(&client_pool_, c);
+    return NULL;
+  }
+  return c;
+}
+
+void NeuroCoreFreeClient(NeuroClient *c) {
+  if (!c)
+    return;
+  free_pool_slot(&client_info_pool_, c->info);
+  free_pool_slot(&client_pool_, c);
+}
+
+// Interned strings live until the core is stopped, so equal strings can be compared by pointer
+const char *NeuroCoreInternString(const char *str) {
+  if (!str)
+    return NULL;
+  return intern_string(&intern_table_, str);
 }
 
 NeuroIndex NeuroCoreGetHeadStack(void) {
@@ -457,72 +1062,65 @@ NeuroClientPtrPtr NeuroCoreFindClient(const NeuroClientTesterFn ctf, const void
   return NULL;
 }
 
+NeuroClientPtrPtr NeuroCoreFindWindowClient(Window w) {
+  const WindowEntry *const e = find_window_entry(&stack_set_.window_index, w);
+  return e ? (NeuroClientPtrPtr)e->node : NULL;
+}
+
 // First, search in the current stack, if is not there, search in the other stacks
-NeuroClientPtrPtr NeuroCoreFindNspClient(void) {
-  Node *n = stack_set_.stack_list[ stack_set_.curr ].nsp;
-  if (n)
-    return (NeuroClientPtrPtr)n;
+NeuroClientPtrPtr NeuroCoreFindAttributeClient(NeuroCoreAttribute a) {
+  NeuroClientPtrPtr c = NeuroCoreStackFindAttributeClient(stack_set_.curr, a);
+  if (c)
+    return c;
   for (NeuroIndex i = 0U; i < stack_set_.size; ++i) {
     if (i == stack_set_.curr)
       continue;
-    n = stack_set_.stack_list[ i ].nsp;
-    if (n)
-      return (NeuroClientPtrPtr)n;
+    c = NeuroCoreStackFindAttributeClient(i, a);
+    if (c)
+      return c;
   }
   return NULL;
 }
 
+NeuroClientPtrPtr NeuroCoreFindNspClient(void) {
+  return NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_NSP);
+}
+
 NeuroClientPtrPtr NeuroCoreAddClientEnd(NeuroClient *c) {
   if (!c)
     return NULL;
-  Stack *const s = stack_set_.stack_list + c->ws;
   Node *const n = new_node(c);
   if (!n)
     return NULL;
-  if (c->is_nsp)
-    s->nsp = n;
-  if (s->size < 1) {
-    s->head = n;
-    s->last = n;
-    set_curr_node(n);
-  } else {
-    n->prev = s->curr;
-    if (s->curr->next)
-      s->curr->next->prev = n;
-    else
-      s->last = n;
-    n->next = s->curr->next;
-    s->curr->next = n;
-    set_curr_node(n);
+  if (!set_window_entry(&stack_set_.window_index, c->win, n, c)) {
+    delete_node(n);
+    return NULL;
   }
-  s->size++;
+  if (!link_node_end(stack_set_.stack_list + c->ws, n)) {
+    remove_window_entry(&stack_set_.window_index, c->win);
+    delete_node(n);
+    return NULL;
+  }
+  stack_set_.stack_list[ c->ws ].is_stacking_known = false;
   return (NeuroClientPtrPtr)n;
 }
 
 NeuroClientPtrPtr NeuroCoreAddClientStart(NeuroClient *c) {
   if (!c)
     return NULL;
-  Stack *const s = stack_set_.stack_list + c->ws;
   Node *const n = new_node(c);
   if (!n)
     return NULL;
-  if (c->is_nsp)
-    s->nsp = n;
-  if (s->size < 1) {
-    s->head = n;
-    s->last = n;
-    set_curr_node(n);
-  } else {
-    n->next = s->curr;
-    if (s->curr->prev)
-      s->curr->prev->next = n;
-    else
-      s->head = n;
-    n->prev = s->curr->prev;
-    s->curr->prev = n;
-    set_curr_node(n);
+  if (!set_window_entry(&stack_set_.window_index, c->win, n, c)) {
+    delete_node(n);
+    return NULL;
   }
-  s->size++;
+  if (!link_node_start(stack_set_.stack_list + c->ws, n)) {
+    remove_window_entry(&stack_set_.window_index, c->win);
+    delete_node(n);
+    return NULL;
+  }
+  stack_set_.stack_list[ c->ws ].is_stacking_known = false;
   return (NeuroClientPtrPtr)n;
 }
 
@@ -530,9 +1128,24 @@ NeuroClientPtrPtr NeuroCoreAddClientStart(NeuroClient *c) {
 NeuroClient *NeuroCoreRemoveClient(NeuroClientPtrPtr c) {
   if (!c)
     return NULL;
+  return remove_node(stack_set_.stack_list + NEURO_CLIENT_PTR(c)->ws, (Node *)c);
+}
 
-  return NeuroCoreClientIsLast(c) ? remove_last_node(stack_set_.stack_list + NEURO_CLIENT_PTR(c)->ws) :
-      remove_no_last_node((Node *)c);
+// Moves the client to the start of the stack ws reusing its node, like removing and adding it back would do
+NeuroClientPtrPtr NeuroCoreClientMove(NeuroClientPtrPtr c, NeuroIndex ws) {
+  if (!c)
+    return NULL;
+  Node *const n = (Node *)c;
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  if (n->ws == ws % stack_set_.size)
+    return c;
+  if (!reserve_stack(s, s->size + 1U))
+    return NULL;
+  unlink_node(stack_set_.stack_list + n->ws, n);
+  n->cli->ws = ws % stack_set_.size;
+  link_node_start(s, n);
+  s->is_stacking_known = false;
+  return c;
 }
 
 NeuroClient *NeuroCorePushMinimizedClient(NeuroClient *c) {
@@ -548,20 +1161,11 @@ NeuroClient *NeuroCorePopMinimizedClient(NeuroIndex ws) {
   return pop_minimized_client(s);
 }
 
-// First, search in the current stack, if is not there, search in the other stacks
 NeuroClient *NeuroCoreRemoveMinimizedClient(Window w) {
-  Stack *const s = stack_set_.stack_list + stack_set_.curr;
-  NeuroClient *c = remove_minimized_client(s, w);
-  if (c)
-    return c;
-  for (NeuroIndex i = 0U; i < stack_set_.size; ++i) {
-    if (i == stack_set_.curr)
-      continue;
-    c = remove_minimized_client(stack_set_.stack_list + i, w);
-    if (c)
-      return c;
-  }
-  return NULL;
+  const WindowEntry *const e = find_window_entry(&stack_set_.window_index, w);
+  if (!e || e->node)
+    return NULL;
+  return remove_minimized_client(stack_set_.stack_list + (e->cli->ws % stack_set_.size), e->cli);
 }
 
 bool NeuroCoreStackIsCurr(NeuroIndex ws) {
@@ -580,20 +1184,25 @@ const NeuroMonitor *NeuroCoreStackGetMonitor(NeuroIndex ws) {
   return stack_set_.stack_list[ ws % stack_set_.size ].monitor;
 }
 
+// Note: the generation is only bumped if the region or the gaps of the stack change
 void NeuroCoreStackSetMonitor(NeuroIndex ws, const NeuroMonitor *m) {
   Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
-  if (m) {
-    memmove(&s->region, &m->region, sizeof(NeuroRectangle));
-    s->gaps = m->gaps;
-    // NeuroCoreStackSetMonitor(m->ws, NULL);
-  } else {
-    const NeuroRectangle *const hidden_region = NeuroSystemGetHiddenRegion();
-    memmove(&s->region, hidden_region, sizeof(NeuroRectangle));
-    s->gaps = NeuroSystemGetHiddenGaps();
+  const NeuroRectangle *const region = m ? &m->region : NeuroSystemGetHiddenRegion();
+  const int *const gaps = m ? m->gaps : NeuroSystemGetHiddenGaps();
+  // NeuroCoreStackSetMonitor(m->ws, NULL);
+  if (s->gaps != gaps || memcmp(&s->region, region, sizeof(NeuroRectangle))) {
+    memmove(&s->region, region, sizeof(NeuroRectangle));
+    s->gaps = gaps;
+    bump_generation(s);
   }
   s->monitor = m;
 }
 
+// Hides the stack keeping its region and gaps, so that its clients do not need to be arranged again
+void NeuroCoreStackDetachMonitor(NeuroIndex ws) {
+  stack_set_.stack_list[ ws % stack_set_.size ].monitor = NULL;
+}
+
 const char *NeuroCoreStackGetName(NeuroIndex ws) {
   return stack_set_.stack_list[ ws % stack_set_.size ].name;
 }
@@ -624,6 +1233,7 @@ bool NeuroCoreStackIsCurrToggledLayout(NeuroIndex ws) {
 void NeuroCoreStackSetLayoutIdx(NeuroIndex ws, NeuroIndex i) {
   Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
   s->curr_layout_index = i % s->num_layouts;
+  bump_generation(s);
 }
 
 void NeuroCoreStackSetToggledLayout(NeuroIndex ws, NeuroIndex *i) {
@@ -634,6 +1244,7 @@ void NeuroCoreStackSetToggledLayout(NeuroIndex ws, NeuroIndex *i) {
   } else {
     s->is_toggled_layout = false;
   }
+  bump_generation(s);
 }
 
 NeuroLayout *NeuroCoreStackGetLayout(NeuroIndex ws, NeuroIndex i) {
@@ -667,6 +1278,73 @@ const int *NeuroCoreStackGetGaps(NeuroIndex ws) {
   return s->gaps;
 }
 
+NeuroIndex NeuroCoreStackGetGeneration(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].generation;
+}
+
+// Note: it must be called after modifying the stack through a pointer returned by the core (regions, layouts...)
+void NeuroCoreStackBumpGeneration(NeuroIndex ws) {
+  bump_generation(stack_set_.stack_list + (ws % stack_set_.size));
+}
+
+bool NeuroCoreStackIsArranged(NeuroIndex ws, const NeuroLayout *l) {
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return s->arranged_generation == s->generation && s->arranged_layout == l;
+}
+
+void NeuroCoreStackSetArranged(NeuroIndex ws, const NeuroLayout *l) {
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  s->arranged_generation = s->generation;
+  s->arranged_layout = l;
+}
+
+bool NeuroCoreStackIsUpdated(NeuroIndex ws) {
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return s->updated_generation == s->generation;
+}
+
+void NeuroCoreStackSetUpdated(NeuroIndex ws) {
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  s->updated_generation = s->generation;
+}
+
+bool NeuroCoreStackIsRelayoutPending(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].is_relayout_pending;
+}
+
+void NeuroCoreStackSetRelayoutPending(NeuroIndex ws, bool is_pending) {
+  stack_set_.stack_list[ ws % stack_set_.size ].is_relayout_pending = is_pending;
+}
+
+bool NeuroCoreStackIsStackingKnown(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].is_stacking_known;
+}
+
+void NeuroCoreStackSetStackingKnown(NeuroIndex ws, bool is_known) {
+  stack_set_.stack_list[ ws % stack_set_.size ].is_stacking_known = is_known;
+}
+
+NeuroArrange *NeuroCoreStackGetArrange(NeuroIndex ws, NeuroIndex size) {
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  if (!reserve_arrange(s, size))
+    return NULL;
+  return &s->arrange;
+}
+
+// Note: the coordinate arrays are reset on every call, so arrangers can swap them freely
+NeuroDenseArrange *NeuroCoreStackGetDenseArrange(NeuroIndex ws, NeuroIndex size) {
+  Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  if (!reserve_arrange(s, size))
+    return NULL;
+  NeuroDenseArrange *const d = &s->dense_arrange;
+  const NeuroIndex cap = s->arrange_capacity;
+  d->xs = s->arrange_coords;
+  d->ys = s->arrange_coords + cap;
+  d->ws = s->arrange_coords + 2U*cap;
+  d->hs = s->arrange_coords + 3U*cap;
+  return d;
+}
+
 NeuroClientPtrPtr NeuroCoreStackGetCurrClient(NeuroIndex ws) {
   return (NeuroClientPtrPtr)(stack_set_.stack_list[ ws % stack_set_.size ].curr);
 }
@@ -676,50 +1354,99 @@ NeuroClientPtrPtr NeuroCoreStackGetPrevClient(NeuroIndex ws) {
 }
 
 NeuroClientPtrPtr NeuroCoreStackGetHeadClient(NeuroIndex ws) {
-  return (NeuroClientPtrPtr)(stack_set_.stack_list[ ws % stack_set_.size ].head);
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return s->size > 0U ? (NeuroClientPtrPtr)s->nodes[ 0 ] : NULL;
 }
 
 NeuroClientPtrPtr NeuroCoreStackGetLastClient(NeuroIndex ws) {
-  return (NeuroClientPtrPtr)(stack_set_.stack_list[ ws % stack_set_.size ].last);
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return s->size > 0U ? (NeuroClientPtrPtr)s->nodes[ s->size - 1U ] : NULL;
+}
+
+NeuroClientPtrPtr NeuroCoreStackGetClient(NeuroIndex ws, NeuroIndex i) {
+  const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
+  return i < s->size ? (NeuroClientPtrPtr)s->nodes[ i ] : NULL;
+}
+
+// Note: the returned arrays are indexed by position and are only valid until the stack membership changes
+const Window *NeuroCoreStackGetWindows(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].wins;
+}
+
+NeuroRectangle *NeuroCoreStackGetClientRegions(NeuroIndex ws) {
+  return stack_set_.stack_list[ ws % stack_set_.size ].regions;
+}
+
+NeuroClientPtrPtr NeuroCoreStackFindWindowClient(NeuroIndex ws, Window w) {
+  const NeuroClientPtrPtr c = NeuroCoreFindWindowClient(w);
+  return c && NEURO_CLIENT_PTR(c)->ws == ws % stack_set_.size ? c : NULL;
+}
+
+NeuroIndex NeuroCoreStackGetAttributeNum(NeuroIndex ws, NeuroCoreAttribute a) {
+  assert(a < NEURO_CORE_ATTRIBUTE_END);
+  return stack_set_.stack_list[ ws % stack_set_.size ].attr_num[ a ];
+}
+
+// Note: it returns the client that got the attribute last
+NeuroClientPtrPtr NeuroCoreStackFindAttributeClient(NeuroIndex ws, NeuroCoreAttribute a) {
+  assert(a < NEURO_CORE_ATTRIBUTE_END);
+  return (NeuroClientPtrPtr)stack_set_.stack_list[ ws % stack_set_.size ].attr_head[ a ];
 }
 
 NeuroClientPtrPtr NeuroCoreStackFindClient(NeuroIndex ws, const NeuroClientTesterFn ctf, const void *data) {
   assert(ctf);
   const Stack *const s = stack_set_.stack_list + (ws % stack_set_.size);
-  for (Node *n = s->head; n; n = n->next)
-    if (ctf((NeuroClientPtrPtr)n, data))
-      return (NeuroClientPtrPtr)n;
+  for (NeuroIndex i = 0U; i < s->size; ++i)
+    if (ctf((NeuroClientPtrPtr)s->nodes[ i ], data))
+      return (NeuroClientPtrPtr)s->nodes[ i ];
   return NULL;
 }
 
 // Client
+bool NeuroCoreClientIsValid(const NeuroClientPtrPtr c) {
+  return is_valid_node((const Node *)c);
+}
+
 bool NeuroCoreClientIsCurr(const NeuroClientPtrPtr c) {
-  return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].curr;
+  return c && (Node *)c == stack_set_.stack_list[ ((Node *)c)->ws ].curr;
 }
 
 bool NeuroCoreClientIsPrev(const NeuroClientPtrPtr c) {
-  return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].prev;
+  return c && (Node *)c == stack_set_.stack_list[ ((Node *)c)->ws ].prev;
 }
 
 bool NeuroCoreClientIsHead(const NeuroClientPtrPtr c) {
-  return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].head;
+  return c && ((Node *)c)->idx == 0U;
 }
 
 bool NeuroCoreClientIsLast(const NeuroClientPtrPtr c) {
-  return c && (Node *)c == stack_set_.stack_list[ NEURO_CLIENT_PTR(c)->ws ].last;
+  return c && ((Node *)c)->idx + 1U == stack_set_.stack_list[ ((Node *)c)->ws ].size;
 }
 
+// Note: the returned region is only valid until the stack membership changes
 NeuroRectangle *NeuroCoreClientGetRegion(const NeuroClientPtrPtr c) {
-  Node *const n = (Node *)c;
-  return !c ? NULL : &n->region;
+  if (!c)
+    return NULL;
+  const Node *const n = (const Node *)c;
+  assert(is_valid_node(n));
+  return stack_set_.stack_list[ n->ws ].regions + n->idx;
 }
 
 NeuroClientPtrPtr NeuroCoreClientGetNext(const NeuroClientPtrPtr c) {
-  return !c ? NULL : (NeuroClientPtrPtr)(((Node *)c)->next);
+  if (!c)
+    return NULL;
+  const Node *const n = (const Node *)c;
+  assert(is_valid_node(n));
+  const Stack *const s = stack_set_.stack_list + n->ws;
+  return n->idx + 1U < s->size ? (NeuroClientPtrPtr)s->nodes[ n->idx + 1U ] : NULL;
 }
 
 NeuroClientPtrPtr NeuroCoreClientGetPrev(const NeuroClientPtrPtr c) {
-  return !c ? NULL : (NeuroClientPtrPtr)(((Node *)c)->prev);
+  if (!c)
+    return NULL;
+  const Node *const n = (const Node *)c;
+  assert(is_valid_node(n));
+  return n->idx > 0U ? (NeuroClientPtrPtr)stack_set_.stack_list[ n->ws ].nodes[ n->idx - 1U ] : NULL;
 }
 
 NeuroClientPtrPtr NeuroCoreClientSwap(const NeuroClientPtrPtr c1, const NeuroClientPtrPtr c2) {
@@ -727,9 +1454,44 @@ NeuroClientPtrPtr NeuroCoreClientSwap(const NeuroClientPtrPtr c1, const NeuroCli
     return NULL;
   Node *const n1 = (Node *)c1;
   Node *const n2 = (Node *)c2;
+  assert(is_valid_node(n1));
+  assert(is_valid_node(n2));
+  Stack *const s1 = stack_set_.stack_list + n1->ws;
+  Stack *const s2 = stack_set_.stack_list + n2->ws;
+  unlink_attributes(s1, n1);
+  unlink_attributes(s2, n2);
   NeuroClient *const t = n1->cli;
   n1->cli = n2->cli;
   n2->cli = t;
+  s1->wins[ n1->idx ] = n1->cli->win;
+  s2->wins[ n2->idx ] = n2->cli->win;
+  link_attributes(s1, n1);
+  link_attributes(s2, n2);
+  bump_generation(s1);
+  bump_generation(s2);
+  set_window_entry(&stack_set_.window_index, n1->cli->win, n1, n1->cli);
+  set_window_entry(&stack_set_.window_index, n2->cli->win, n2, n2->cli);
   return c2;
 }
 
+// Note: the client attributes must be changed with these setters while the client is in a stack
+void NeuroCoreClientSetUrgent(NeuroClientPtrPtr c, bool is_urgent) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->is_urgent = is_urgent;
+  set_node_attribute((Node *)c, NEURO_CORE_ATTRIBUTE_URGENT, is_urgent);
+}
+
+void NeuroCoreClientSetFullscreen(NeuroClientPtrPtr c, bool is_fullscreen) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->is_fullscreen = is_fullscreen;
+  set_node_attribute((Node *)c, NEURO_CORE_ATTRIBUTE_FULLSCREEN, is_fullscreen);
+}
+
+void NeuroCoreClientSetFreeSetter(NeuroClientPtrPtr c, NeuroFreeSetterFn free_setter_fn) {
+  if (!c)
+    return;
+  NEURO_CLIENT_PTR(c)->free_setter_fn = free_setter_fn;
+  set_node_attribute((Node *)c, NEURO_CORE_ATTRIBUTE_FREE, free_setter_fn != NeuroRuleFreeSetterNull);
+}
@@ -17,6 +17,22 @@
 #include "type.h"
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// NeuroCoreAttribute (client attributes indexed by every stack)
+enum NeuroCoreAttribute {
+  NEURO_CORE_ATTRIBUTE_NSP = 0,
+  NEURO_CORE_ATTRIBUTE_FIXED,
+  NEURO_CORE_ATTRIBUTE_FULLSCREEN,
+  NEURO_CORE_ATTRIBUTE_URGENT,
+  NEURO_CORE_ATTRIBUTE_FREE,
+  NEURO_CORE_ATTRIBUTE_END
+};
+typedef enum NeuroCoreAttribute NeuroCoreAttribute;
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // FUNCTION DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
@@ -24,6 +40,11 @@
 // StackSet
 bool NeuroCoreInit(void);
 void NeuroCoreStop(void);
+const NeuroPoolStats *NeuroCoreGetNodePoolStats(void);
+const NeuroPoolStats *NeuroCoreGetClientPoolStats(void);
+NeuroClient *NeuroCoreAllocClient(void);
+void NeuroCoreFreeClient(NeuroClient *c);
+const char *NeuroCoreInternString(const char *str);
 NeuroIndex NeuroCoreGetHeadStack(void);
 NeuroIndex NeuroCoreGetLastStack(void);
 NeuroIndex NeuroCoreGetCurrStack(void);
@@ -38,6 +59,8 @@ NeuroClientPtrPtr NeuroCoreGetCurrClientNspStack(void);
 void NeuroCoreSetCurrStack(NeuroIndex ws);
 void NeuroCoreSetCurrClient(NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreFindClient(const NeuroClientTesterFn ctf, const void *data);
+NeuroClientPtrPtr NeuroCoreFindWindowClient(Window w);
+NeuroClientPtrPtr NeuroCoreFindAttributeClient(NeuroCoreAttribute a);
 NeuroClientPtrPtr NeuroCoreFindNspClient(void);
 NeuroClientPtrPtr NeuroCoreAddClientEnd(NeuroClient *c);
 NeuroClientPtrPtr NeuroCoreAddClientStart(NeuroClient *c);
@@ -52,6 +75,7 @@ bool NeuroCoreStackIsNsp(NeuroIndex ws);
 bool NeuroCoreStackIsEmpty(NeuroIndex ws);
 const NeuroMonitor *NeuroCoreStackGetMonitor(NeuroIndex ws);
 void NeuroCoreStackSetMonitor(NeuroIndex ws, const NeuroMonitor *m);
+void NeuroCoreStackDetachMonitor(NeuroIndex ws);
 const char *NeuroCoreStackGetName(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetSize(NeuroIndex ws);
 NeuroIndex NeuroCoreStackGetMinimizedNum(NeuroIndex ws);
@@ -66,13 +90,32 @@ NeuroLayout *NeuroCoreStackGetCurrLayout(NeuroIndex ws);
 const NeuroLayoutConf *NeuroCoreStackGetCurrLayoutConf(NeuroIndex ws);
 NeuroRectangle *NeuroCoreStackGetRegion(NeuroIndex ws);
 const int *NeuroCoreStackGetGaps(NeuroIndex ws);
+NeuroIndex NeuroCoreStackGetGeneration(NeuroIndex ws);
+void NeuroCoreStackBumpGeneration(NeuroIndex ws);
+bool NeuroCoreStackIsArranged(NeuroIndex ws, const NeuroLayout *l);
+void NeuroCoreStackSetArranged(NeuroIndex ws, const NeuroLayout *l);
+bool NeuroCoreStackIsUpdated(NeuroIndex ws);
+void NeuroCoreStackSetUpdated(NeuroIndex ws);
+bool NeuroCoreStackIsRelayoutPending(NeuroIndex ws);
+void NeuroCoreStackSetRelayoutPending(NeuroIndex ws, bool is_pending);
+bool NeuroCoreStackIsStackingKnown(NeuroIndex ws);
+void NeuroCoreStackSetStackingKnown(NeuroIndex ws, bool is_known);
+NeuroArrange *NeuroCoreStackGetArrange(NeuroIndex ws, NeuroIndex size);
+NeuroDenseArrange *NeuroCoreStackGetDenseArrange(NeuroIndex ws, NeuroIndex size);
 NeuroClientPtrPtr NeuroCoreStackGetCurrClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackGetPrevClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackGetHeadClient(NeuroIndex ws);
 NeuroClientPtrPtr NeuroCoreStackGetLastClient(NeuroIndex ws);
+NeuroClientPtrPtr NeuroCoreStackGetClient(NeuroIndex ws, NeuroIndex i);
+const Window *NeuroCoreStackGetWindows(NeuroIndex ws);
+NeuroRectangle *NeuroCoreStackGetClientRegions(NeuroIndex ws);
+NeuroClientPtrPtr NeuroCoreStackFindWindowClient(NeuroIndex ws, Window w);
+NeuroIndex NeuroCoreStackGetAttributeNum(NeuroIndex ws, NeuroCoreAttribute a);
+NeuroClientPtrPtr NeuroCoreStackFindAttributeClient(NeuroIndex ws, NeuroCoreAttribute a);
 NeuroClientPtrPtr NeuroCoreStackFindClient(NeuroIndex ws, const NeuroClientTesterFn ctf, const void *p);
 
 // Client
+bool NeuroCoreClientIsValid(const NeuroClientPtrPtr c);
 bool NeuroCoreClientIsCurr(const NeuroClientPtrPtr c);
 bool NeuroCoreClientIsPrev(const NeuroClientPtrPtr c);
 bool NeuroCoreClientIsHead(const NeuroClientPtrPtr c);
@@ -81,4 +124,8 @@ NeuroRectangle *NeuroCoreClientGetRegion(const NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientGetNext(const NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientGetPrev(const NeuroClientPtrPtr c);
 NeuroClientPtrPtr NeuroCoreClientSwap(const NeuroClientPtrPtr c1, const NeuroClientPtrPtr c2);
+NeuroClientPtrPtr NeuroCoreClientMove(NeuroClientPtrPtr c, NeuroIndex ws);
+void NeuroCoreClientSetUrgent(NeuroClientPtrPtr c, bool is_urgent);
+void NeuroCoreClientSetFullscreen(NeuroClientPtrPtr c, bool is_fullscreen);
+void NeuroCoreClientSetFreeSetter(NeuroClientPtrPtr c, NeuroFreeSetterFn free_setter_fn);
 
@@ -52,6 +52,11 @@ struct PipeInfo {
   const NeuroMonitor *monitor;
   int output;
   pid_t pid;
+  NeuroDzenChange changes;          // Inputs the panel depends on
+  NeuroDzenChange pending_changes;  // Inputs changed since the last write
+  int64_t last_refresh;             // Time of the last write in milliseconds
+  char *backlog;                    // Line left to write when the pipe was full
+  size_t backlog_size;
 };
 
 typedef struct DzenRefreshInfo DzenRefreshInfo;
@@ -64,6 +69,15 @@ struct DzenRefreshInfo {
   PipeInfo *pipe_info;
   NeuroIndex num_panels;
   uint32_t reset_rate;
+  uint32_t tick;               // Seconds elapsed modulo reset_rate
+  bool is_frame_requested;     // A panel write has been deferred to the next frame
+};
+
+// LoggerChanges (inputs the built-in loggers depend on)
+typedef struct LoggerChanges LoggerChanges;
+struct LoggerChanges {
+  NeuroDzenLoggerFn logger_fn;
+  NeuroDzenChange changes;
 };
 
 
@@ -78,6 +92,20 @@ static bool cpu_calc_stop_refresh_cond_ = false;
 // Dzen
 static DzenRefreshInfo dzen_refresh_info_;
 static bool dzen_stop_refresh_cond_ = false;
+static bool is_threaded_ = true;  // The panels and the cpu are refreshed by their own threads
+static const LoggerChanges logger_changes_[] = {
+  { NeuroDzenLoggerTime, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerDate, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerDay, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerUptime, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerCpu, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerRam, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerWifiStrength, NEURO_DZEN_CHANGE_NULL },
+  { NeuroDzenLoggerMonitorWorkspace, NEURO_DZEN_CHANGE_WORKSPACE },
+  { NeuroDzenLoggerMonitorCurrLayout, NEURO_DZEN_CHANGE_WORKSPACE | NEURO_DZEN_CHANGE_LAYOUT },
+  { NeuroDzenLoggerMonitorCurrTitle, NEURO_DZEN_CHANGE_WORKSPACE | NEURO_DZEN_CHANGE_TITLE |
+      NEURO_DZEN_CHANGE_STACK }
+};
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -134,43 +162,43 @@ static void get_perc_info(CpuInfo *cpu_info, uint64_t *cpu_vals, uint64_t prev_i
   cpu_info->perc = (100 * (diff_total - diff_idle)) / diff_total;
 }
 
-static void refresh_cpu_calc(const char *file, NeuroIndex ncpus) {
+// Note: The previous sample of every cpu is the one stored in cpu_info
+static bool sample_cpu_calc(const char *file, NeuroIndex ncpus) {
   assert(file);
   uint64_t cpus_file_info[ ncpus ][ CPU_MAX_VALS ];
-  uint64_t prev_idle[ ncpus ], prev_total[ ncpus ];
-  memset(prev_idle, 0, sizeof(prev_idle));
-  memset(prev_total, 0, sizeof(prev_total));
 
-  while (true) {
-    // Open the file
-    FILE *const fd = fopen(file, "r");
-    if (!fd)
-      return;
-
-    // Do the percent calculation
-    char buf[ 256 ];
-    for (NeuroIndex i = 0U; i < ncpus; ++i) {
-      fgets(buf, sizeof(buf), fd);
-      if (EOF == sscanf(buf + 5, "%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64
-          " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64,
-          cpus_file_info[ i ] + 0, cpus_file_info[ i ] + 1,
-          cpus_file_info[ i ] + 2, cpus_file_info[ i ] + 3,
-          cpus_file_info[ i ] + 4, cpus_file_info[ i ] + 5,
-          cpus_file_info[ i ] + 6, cpus_file_info[ i ] + 7,
-          cpus_file_info[ i ] + 8, cpus_file_info[ i ] + 9))
-        return;
-      get_perc_info(cpu_calc_refresh_info_.cpu_info + i, cpus_file_info[ i ], prev_idle[ i ], prev_total[ i ]);
-      prev_idle[ i ] = cpu_calc_refresh_info_.cpu_info[ i ].idle;
-      prev_total[ i ] = cpu_calc_refresh_info_.cpu_info[ i ].total;
+  // Open the file
+  FILE *const fd = fopen(file, "r");
+  if (!fd)
+    return false;
+
+  // Do the percent calculation
+  char buf[ 256 ];
+  for (NeuroIndex i = 0U; i < ncpus; ++i) {
+    fgets(buf, sizeof(buf), fd);
+    if (EOF == sscanf(buf + 5, "%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64
+        " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64,
+        cpus_file_info[ i ] + 0, cpus_file_info[ i ] + 1,
+        cpus_file_info[ i ] + 2, cpus_file_info[ i ] + 3,
+        cpus_file_info[ i ] + 4, cpus_file_info[ i ] + 5,
+        cpus_file_info[ i ] + 6, cpus_file_info[ i ] + 7,
+        cpus_file_info[ i ] + 8, cpus_file_info[ i ] + 9)) {
+      fclose(fd);
+      return false;
     }
+    CpuInfo *const ci = cpu_calc_refresh_info_.cpu_info + i;
+    get_perc_info(ci, cpus_file_info[ i ], ci->idle, ci->total);
+  }
 
-    // Close the file
-    fclose(fd);
+  // Close the file
+  fclose(fd);
+  return true;
+}
 
-    // Wait 1 second or break if the conditional variable has been signaled
-    if (!cpu_calc_refresh_timedwait(1))
-      break;
-  }
+static void refresh_cpu_calc(const char *file, NeuroIndex ncpus) {
+  // Sample every second until the conditional variable has been signaled
+  while (sample_cpu_calc(file, ncpus) && cpu_calc_refresh_timedwait(1))
+    continue;
 }
 
 static void *refresh_cpu_calc_thread(void *args) {
@@ -217,9 +245,33 @@ static void stop_cpu_calc_refresh_info(void) {
 }
 
 // Dzen (Thread 2)
-static bool dzen_refresh_timedwait(time_t seconds) {
-  return cond_timedwait(seconds, &dzen_stop_refresh_cond_, &dzen_refresh_info_.wait_mutex,
-      &dzen_refresh_info_.wait_cond);
+static int64_t get_time_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+// Note: Returns false if the thread has been stopped, the wait_cond clock is CLOCK_MONOTONIC
+static bool dzen_refresh_wait_until(int64_t deadline_ms) {
+  const struct timespec deadline = { (time_t)(deadline_ms / 1000), (long)(deadline_ms % 1000) * 1000000L };
+  pthread_mutex_lock(&dzen_refresh_info_.wait_mutex);
+  while (!dzen_stop_refresh_cond_ && !dzen_refresh_info_.is_frame_requested)
+    if (ETIMEDOUT == pthread_cond_timedwait(&dzen_refresh_info_.wait_cond, &dzen_refresh_info_.wait_mutex,
+        &deadline))
+      break;
+  dzen_refresh_info_.is_frame_requested = false;
+  const bool is_running = !dzen_stop_refresh_cond_;
+  pthread_mutex_unlock(&dzen_refresh_info_.wait_mutex);
+  return is_running;
+}
+
+static void request_dzen_frame(void) {
+  if (!is_threaded_ || dzen_refresh_info_.reset_rate == 0U)
+    return;
+  pthread_mutex_lock(&dzen_refresh_info_.wait_mutex);
+  dzen_refresh_info_.is_frame_requested = true;
+  pthread_cond_signal(&dzen_refresh_info_.wait_cond);
+  pthread_mutex_unlock(&dzen_refresh_info_.wait_mutex);
 }
 
 static char **str_to_cmd(char **cmd, char *str, const char *sep) {
@@ -248,13 +300,36 @@ static char **get_dzen_cmd(char **cmd, char *line, const NeuroDzenFlags *df, con
   return str_to_cmd(cmd, line, " \t\n");
 }
 
-static void refresh_dzen(const NeuroMonitor *m, const NeuroDzenPanel *dp, int fd) {
-  assert(dp);
+// Note: Returns false if the pipe is full, the rest of the line is kept in the backlog
+static bool write_dzen_line(PipeInfo *pi, const char *line, size_t size) {
+  assert(pi);
+  assert(line);
+  ssize_t written = write(pi->output, line, size);
+  if (written < 0)
+    written = (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : (ssize_t)size;
+  if ((size_t)written >= size) {
+    pi->backlog_size = 0U;
+    return true;
+  }
+  if (!pi->backlog && !(pi->backlog = (char *)malloc(NEURO_DZEN_LINE_MAX)))
+    return true;
+  memmove(pi->backlog, line + written, size - (size_t)written);
+  pi->backlog_size = size - (size_t)written;
+  return false;
+}
 
-  // Lock
-  pthread_mutex_lock(&dzen_refresh_info_.sync_mutex);
+// Note: sync_mutex must be locked
+static void write_dzen(PipeInfo *pi) {
+  assert(pi);
 
-  // Refresh
+  // Refresh again once the pipe can take the line left to write
+  if (pi->backlog_size > 0U) {
+    pi->pending_changes = NEURO_DZEN_CHANGE_ALL;
+    return;
+  }
+
+  const NeuroDzenPanel *const dp = pi->dzen_panel;
+  const NeuroMonitor *const m = pi->monitor;
   char line[ NEURO_DZEN_LINE_MAX ] = "\0";
   for (NeuroIndex i = 0U; dp->loggers[ i ]; ++i) {
     char str[ NEURO_DZEN_LOGGER_MAX ] = "\0";
@@ -268,47 +343,97 @@ static void refresh_dzen(const NeuroMonitor *m, const NeuroDzenPanel *dp, int fd
 
   // Line must be '\n' terminated so that dzen can display it
   strncat(line, "\n", NEURO_DZEN_LINE_MAX - strlen(line) - 1);
-  write(fd, line, strlen(line));
+  write_dzen_line(pi, line, strlen(line));
+  pi->pending_changes = NEURO_DZEN_CHANGE_NULL;
+  pi->last_refresh = get_time_ms();
+}
 
-  // Unlock
+static void refresh_dzen(PipeInfo *pi) {
+  assert(pi);
+  pthread_mutex_lock(&dzen_refresh_info_.sync_mutex);
+  write_dzen(pi);
   pthread_mutex_unlock(&dzen_refresh_info_.sync_mutex);
 }
 
+// Note: Returns the milliseconds left until the pending changes can be written, or -1 if nothing is pending
+static int64_t refresh_dzen_changes(PipeInfo *pi, NeuroDzenChange changes) {
+  assert(pi);
+  pthread_mutex_lock(&dzen_refresh_info_.sync_mutex);
+  pi->pending_changes |= changes & pi->changes;
+  int64_t wait = -1;
+  if (pi->pending_changes != NEURO_DZEN_CHANGE_NULL) {
+    const int64_t now = get_time_ms(), due = pi->last_refresh + NEURO_DZEN_FRAME_INTERVAL;
+    if (now >= due)
+      write_dzen(pi);
+    else
+      wait = due - now;
+  }
+  pthread_mutex_unlock(&dzen_refresh_info_.sync_mutex);
+  return wait;
+}
+
+// Refreshes the timed panels, called every second
+static void tick_dzen(void) {
+  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i) {
+    PipeInfo *const pi = dzen_refresh_info_.pipe_info + i;
+    if (pi->dzen_panel->refresh_rate == NEURO_DZEN_REFRESH_ON_EVENT)
+      continue;
+    if (dzen_refresh_info_.tick % pi->dzen_panel->refresh_rate == 0U)
+      refresh_dzen(pi);
+  }
+  ++dzen_refresh_info_.tick;
+  dzen_refresh_info_.tick %= dzen_refresh_info_.reset_rate;
+}
+
+// Writes the panels whose changes were deferred to the next frame
+// Note: Returns the milliseconds left until the next deferred frame, or -1 if there is none
+static int64_t frame_dzen(void) {
+  int64_t min_wait = -1;
+  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i) {
+    const int64_t wait = refresh_dzen_changes(dzen_refresh_info_.pipe_info + i, NEURO_DZEN_CHANGE_NULL);
+    if (wait >= 0 && (min_wait < 0 || wait < min_wait))
+      min_wait = wait;
+  }
+  return min_wait;
+}
+
 static void *refresh_dzen_thread(void *args) {
   (void)args;
-  uint32_t i = 0U;
+  int64_t next_tick = get_time_ms();
   while (true) {
-    for (NeuroIndex j = 0U; j < dzen_refresh_info_.num_panels; ++j) {
-      const PipeInfo *const pi = dzen_refresh_info_.pipe_info + j;
-      if (pi->dzen_panel->refresh_rate == NEURO_DZEN_REFRESH_ON_EVENT)
-        continue;
-      if (i % pi->dzen_panel->refresh_rate == 0U)
-        refresh_dzen(pi->monitor, pi->dzen_panel, dzen_refresh_info_.pipe_info[ j ].output);
+    // Refresh the timed panels every second
+    const int64_t now = get_time_ms();
+    if (now >= next_tick) {
+      tick_dzen();
+      next_tick += 1000;
     }
-    ++i;
-    i %= dzen_refresh_info_.reset_rate;
 
-    // Wait 1 second or break if the conditional variable has been signaled
-    if (!dzen_refresh_timedwait(1))
+    // Wait until the next tick or frame, or break if the thread has been stopped
+    const int64_t wait = frame_dzen();
+    if (!dzen_refresh_wait_until(wait >= 0 && now + wait < next_tick ? now + wait : next_tick))
       break;
   }
   pthread_exit(NULL);
 }
 
 static bool init_dzen_refresh_thread(void) {
-  if (dzen_refresh_info_.reset_rate == 0U)
+  if (!is_threaded_ || dzen_refresh_info_.reset_rate == 0U)
     return true;
 
   // Init mutex and cond
   pthread_mutex_init(&dzen_refresh_info_.wait_mutex, NULL);
-  pthread_cond_init(&dzen_refresh_info_.wait_cond, NULL);
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&dzen_refresh_info_.wait_cond, &attr);
+  pthread_condattr_destroy(&attr);
 
   // Create thread
   return pthread_create(&dzen_refresh_info_.thread, NULL, refresh_dzen_thread, NULL) == 0;
 }
 
 static void stop_dzen_refresh_thread(void) {
-  if (dzen_refresh_info_.reset_rate == 0U)
+  if (!is_threaded_ || dzen_refresh_info_.reset_rate == 0U)
     return;
 
   // Stop refresh thread
@@ -362,6 +487,10 @@ static bool init_dzen_refresh_info(void) {
         return false;
       dzen_refresh_info_.pipe_info[ panel_iterator ].dzen_panel = dp;
       dzen_refresh_info_.pipe_info[ panel_iterator ].monitor = m;
+      dzen_refresh_info_.pipe_info[ panel_iterator ].changes = NeuroDzenGetPanelChanges(dp);
+      if (!is_threaded_)
+        fcntl(dzen_refresh_info_.pipe_info[ panel_iterator ].output, F_SETFL,
+            fcntl(dzen_refresh_info_.pipe_info[ panel_iterator ].output, F_GETFL) | O_NONBLOCK);
 
       ++panel_iterator;
     }
@@ -377,9 +506,11 @@ static void stop_dzen_refresh_info(void) {
   pthread_mutex_destroy(&dzen_refresh_info_.sync_mutex);
 
   // Release pipe info
-  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i)
+  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i) {
     if (kill(dzen_refresh_info_.pipe_info[ i ].pid, SIGTERM) == -1)
       perror("stop_dzen_refresh_info - Could not kill panels");
+    free(dzen_refresh_info_.pipe_info[ i ].backlog);
+  }
   free(dzen_refresh_info_.pipe_info);
   dzen_refresh_info_.pipe_info = NULL;
 }
@@ -391,6 +522,7 @@ static void stop_dzen_refresh_info(void) {
 
 // Dzen
 bool NeuroDzenInit(void) {
+  is_threaded_ = NeuroConfigGet()->loop_mode != NEURO_LOOP_MODE_EPOLL;
   if (!init_dzen_refresh_info() || !init_dzen_refresh_thread())
     return false;
   NeuroDzenRefresh(false);
@@ -404,27 +536,95 @@ void NeuroDzenStop(void) {
 
 void NeuroDzenRefresh(bool on_event_only) {
   for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i) {
-    const PipeInfo *const pi = dzen_refresh_info_.pipe_info + i;
-    if (on_event_only && (pi->dzen_panel->refresh_rate == NEURO_DZEN_REFRESH_ON_EVENT)) {
-      refresh_dzen(pi->monitor, pi->dzen_panel, dzen_refresh_info_.pipe_info[ i ].output);
+    PipeInfo *const pi = dzen_refresh_info_.pipe_info + i;
+    if (on_event_only && pi->dzen_panel->refresh_rate != NEURO_DZEN_REFRESH_ON_EVENT)
       continue;
-    }
-    refresh_dzen(pi->monitor, pi->dzen_panel, dzen_refresh_info_.pipe_info[ i ].output);
+    refresh_dzen(pi);
   }
 }
 
+void NeuroDzenRefreshChanges(NeuroDzenChange changes) {
+  if (changes == NEURO_DZEN_CHANGE_NULL)
+    return;
+  bool is_deferred = false;
+  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i)
+    if (refresh_dzen_changes(dzen_refresh_info_.pipe_info + i, changes) >= 0)
+      is_deferred = true;
+  if (is_deferred)
+    request_dzen_frame();
+}
+
+// Note: Loggers that are not built-in may depend on anything
+NeuroDzenChange NeuroDzenGetLoggerChanges(NeuroDzenLoggerFn lf) {
+  for (NeuroIndex i = 0U; i < sizeof(logger_changes_)/sizeof(LoggerChanges); ++i)
+    if (logger_changes_[ i ].logger_fn == lf)
+      return logger_changes_[ i ].changes;
+  return NEURO_DZEN_CHANGE_ALL;
+}
+
+NeuroDzenChange NeuroDzenGetPanelChanges(const NeuroDzenPanel *dp) {
+  assert(dp);
+  if (dp->changes != NEURO_DZEN_CHANGE_NULL)
+    return dp->changes;
+  NeuroDzenChange changes = NEURO_DZEN_CHANGE_NULL;
+  for (NeuroIndex i = 0U; dp->loggers[ i ]; ++i)
+    changes |= NeuroDzenGetLoggerChanges(dp->loggers[ i ]);
+  return changes;
+}
+
 void NeuroDzenInitCpuCalc(void) {
   if (!init_cpu_calc_refresh_info())
     NeuroSystemError(__func__, "Could not init cpu calc refresh info");
-  if (!init_cpu_calc_thread())
+  if (is_threaded_ && !init_cpu_calc_thread())
     NeuroSystemError(__func__, "Could not init cpu calc thread");
 }
 
 void NeuroDzenStopCpuCalc(void) {
-  stop_cpu_calc_thread();
+  if (is_threaded_)
+    stop_cpu_calc_thread();
   stop_cpu_calc_refresh_info();
 }
 
+// Event loop mode, the caller must run it every second instead of the refresh threads
+void NeuroDzenTick(void) {
+  if (cpu_calc_refresh_info_.cpu_info)
+    sample_cpu_calc(CPU_FILE_PATH, cpu_calc_refresh_info_.num_cpus);
+  tick_dzen();
+}
+
+// Event loop mode, returns true if NeuroDzenTick must be run every second
+bool NeuroDzenIsTicking(void) {
+  if (cpu_calc_refresh_info_.cpu_info)
+    return true;
+  for (NeuroIndex i = 0U; i < dzen_refresh_info_.num_panels; ++i)
+    if (dzen_refresh_info_.pipe_info[ i ].dzen_panel->refresh_rate != NEURO_DZEN_REFRESH_ON_EVENT)
+      return true;
+  return false;
+}
+
+// Event loop mode, returns the milliseconds left until it must be run again or -1 if nothing is deferred
+int64_t NeuroDzenRunFrame(void) {
+  return frame_dzen();
+}
+
+NeuroIndex NeuroDzenGetNumPanels(void) {
+  return dzen_refresh_info_.num_panels;
+}
+
+int NeuroDzenGetPanelFd(NeuroIndex i) {
+  return dzen_refresh_info_.pipe_info[ i % dzen_refresh_info_.num_panels ].output;
+}
+
+// Event loop mode, writes the rest of the line once the pipe of the panel is writable again
+void NeuroDzenFlushPanel(NeuroIndex i) {
+  PipeInfo *const pi = dzen_refresh_info_.pipe_info + (i % dzen_refresh_info_.num_panels);
+  pthread_mutex_lock(&dzen_refresh_info_.sync_mutex);
+  if (pi->backlog_size > 0U && write_dzen_line(pi, pi->backlog, pi->backlog_size) &&
+      pi->pending_changes != NEURO_DZEN_CHANGE_NULL)
+    write_dzen(pi);
+  pthread_mutex_unlock(&dzen_refresh_info_.sync_mutex);
+}
+
 void NeuroDzenWrapDzenBox(char *dst, const char *src, const NeuroDzenBox *b) {
   assert(dst);
   assert(src);
@@ -581,7 +781,7 @@ void NeuroDzenLoggerMonitorCurrTitle(const NeuroMonitor *m, char *str) {
   assert(str);
   const NeuroClientPtrPtr c = NeuroCoreStackGetCurrClient(NeuroCoreGetMonitorStack(m));
   if (c)
-    strncpy(str, NEURO_CLIENT_PTR(c)->title, NEURO_DZEN_LOGGER_MAX);
+    strncpy(str, NEURO_CLIENT_PTR(c)->info->title, NEURO_DZEN_LOGGER_MAX);
 }
 
 void NeuroDzenLoggerScreen(const NeuroMonitor *m, char *str) {
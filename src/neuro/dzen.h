@@ -21,6 +21,7 @@
 #define NEURO_DZEN_LINE_MAX 16384
 #define NEURO_DZEN_ARGS_MAX 64
 #define NEURO_DZEN_LOGGER_MAX 8192
+#define NEURO_DZEN_FRAME_INTERVAL 16L  // Minimum milliseconds between two writes of a panel
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -31,8 +32,17 @@
 bool NeuroDzenInit(void);
 void NeuroDzenStop(void);
 void NeuroDzenRefresh(bool on_event_only);
+void NeuroDzenRefreshChanges(NeuroDzenChange changes);
+NeuroDzenChange NeuroDzenGetLoggerChanges(NeuroDzenLoggerFn lf);
+NeuroDzenChange NeuroDzenGetPanelChanges(const NeuroDzenPanel *dp);
 void NeuroDzenInitCpuCalc(void);
 void NeuroDzenStopCpuCalc(void);
+bool NeuroDzenIsTicking(void);
+void NeuroDzenTick(void);
+int64_t NeuroDzenRunFrame(void);
+NeuroIndex NeuroDzenGetNumPanels(void);
+int NeuroDzenGetPanelFd(NeuroIndex i);
+void NeuroDzenFlushPanel(NeuroIndex i);
 void NeuroDzenWrapDzenBox(char *dst, const char *src, const NeuroDzenBox *b);
 void NeuroDzenWrapClickArea(char *dst, const char *src, const NeuroDzenClickableArea *ca);
 bool NeuroDzenReadFirstLineFile(char *buf, const char *path);
@@ -26,49 +26,117 @@
 #include "monitor.h"
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool is_batching_ = false;
+static NeuroDzenChange panel_changes_ = NEURO_DZEN_CHANGE_NULL;
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static void do_key_press(XEvent *e) {
-  assert(e);
-  const NeuroKey *const *const key_list = NeuroConfigGet()->key_list;
-  if (!key_list)
+static void refresh_panels(NeuroDzenChange changes) {
+  if (is_batching_)
+    panel_changes_ |= changes;
+  else
+    NeuroDzenRefreshChanges(changes);
+}
+
+static void relayout_stack(NeuroIndex ws) {
+  NeuroLayoutRunCurr(ws);
+  NeuroWorkspaceUpdate(ws);
+  NeuroWorkspaceFocus(ws);
+  NeuroClientFlushUpdates();
+}
+
+// Defers the relayout of the stack to the end of the batch, or runs it right away when not batching
+static void request_relayout(NeuroIndex ws) {
+  if (is_batching_)
+    NeuroCoreStackSetRelayoutPending(ws, true);
+  else
+    relayout_stack(ws);
+}
+
+static void manage_fetched_window(const NeuroFetchedWindow *fw) {
+  assert(fw);
+  if (!fw->has_attributes || fw->wa.override_redirect)
     return;
+  if (NeuroClientFindWindow(fw->win))
+    return;
+
+  // Add client to the stack list
+  NeuroClient *const cli = NeuroRuleNewFetchedClient(fw);
+  if (!cli)
+    NeuroSystemError(__func__, "Could not alloc NeuroClient and set rules");
+  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  if (!c)
+    NeuroSystemError(__func__, "Could not add client");
+
+  // Transient windows
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  Window trans = None;
+  if (NeuroFetchGetTransientFor(&trans, fw)) {
+    NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterFit);
+    NeuroClientPtrPtr t = NeuroClientFindWindow(trans);
+    if (t)
+      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreClientGetRegion(t));
+    else
+      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreStackGetRegion(client->ws));
+    NeuroCoreStackBumpGeneration(client->ws);
+  }
+
+  // The update maps the window after it is moved and resized, or unmaps it if it is viewable in an unmapped workspace
+  XSelectInput(NeuroSystemGetDisplay(), client->win, NEURO_SYSTEM_CLIENT_MASK);
+  NeuroSystemGrabButtons(client->win, NeuroConfigGet()->button_list);
+  client->info->shadow.is_hidden = fw->wa.map_state != IsViewable;
+  if (NeuroConfigGet()->hide_mode == NEURO_HIDE_MODE_REPARENT)
+    XAddToSaveSet(NeuroSystemGetDisplay(), client->win);
+  NeuroSystemSetWmState(client->win, client->info->shadow.is_hidden ? IconicState : NormalState);
+  request_relayout(client->ws);
+}
 
-  const XKeyEvent ke = e->xkey;
-  int ks = 0;
-  KeySym *const key_sym = XGetKeyboardMapping(NeuroSystemGetDisplay(), ke.keycode, 1, &ks);
-  for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
-    const NeuroKey *k = key_list[ i ];
-    if (k->key == *key_sym && k->mod == ke.state) {
-      NeuroActionRunActionChain(&k->action_chain);
-      NeuroDzenRefresh(true);
-    }
+static void do_key_press(XEvent *e) {
+  assert(e);
+  const XKeyEvent *const ev = &e->xkey;
+  const NeuroKey *keys[ NEURO_SYSTEM_BINDING_MATCH_MAX ];
+  const NeuroIndex n = NeuroSystemFindKeyBindings(keys, ev->keycode, ev->state);
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    NeuroActionRunActionChain(&keys[ i ]->action_chain);
+    refresh_panels(NEURO_DZEN_CHANGE_ALL);
   }
-  XFree(key_sym);
 }
 
 static void do_button_press(XEvent *e) {
   assert(e);
-  const NeuroButton *const *const button_list = NeuroConfigGet()->button_list;
-  if (!button_list)
-    return;
-
   const XButtonPressedEvent *const ev = &e->xbutton;
-  for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
-    const NeuroButton *b = button_list[ i ];
-    if (b->button == ev->button && b->mod == ev->state) {
-      NeuroActionRunActionChain(&b->action_chain);
-      NeuroDzenRefresh(true);
-    }
+  const NeuroButton *buttons[ NEURO_SYSTEM_BINDING_MATCH_MAX ];
+  const NeuroIndex n = NeuroSystemFindButtonBindings(buttons, ev->button, ev->state);
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    NeuroActionRunActionChain(&buttons[ i ]->action_chain);
+    refresh_panels(NEURO_DZEN_CHANGE_ALL);
   }
 }
 
+static void do_mapping_notify(XEvent *e) {
+  assert(e);
+  XMappingEvent *const ev = &e->xmapping;
+  XRefreshKeyboardMapping(ev);
+  if (ev->request != MappingKeyboard && ev->request != MappingModifier)
+    return;
+
+  // Keycodes or the NumLock modifier may have changed, rebuild the dispatch tables and grab the keys again
+  if (!NeuroSystemUpdateBindings())
+    NeuroSystemError(__func__, "Could not update the bindings");
+  NeuroSystemGrabKeys(NeuroSystemGetRoot(), NeuroConfigGet()->key_list);
+}
+
 static void do_map_request(XEvent *e) {
   assert(e);
   NeuroEventManageWindow(e->xmaprequest.window);
-  NeuroDzenRefresh(true);
+  refresh_panels(NEURO_DZEN_CHANGE_STACK | NEURO_DZEN_CHANGE_TITLE);
 }
 
 static void do_destroy_notify(XEvent *e) {
@@ -81,25 +149,40 @@ static void do_destroy_notify(XEvent *e) {
     NeuroClient *cli = NeuroCoreRemoveMinimizedClient(w);
     NeuroTypeDeleteClient(cli);
   }
-  NeuroDzenRefresh(true);
+  refresh_panels(NEURO_DZEN_CHANGE_STACK | NEURO_DZEN_CHANGE_TITLE);
 }
 
+// Note: unmaps of the WM are not withdrawals, but synthetic UnmapNotify events always are (ICCCM 4.1.4)
 static void do_unmap_notify(XEvent *e) {
   assert(e);
-  const Window w = e->xdestroywindow.window;
+  const XUnmapEvent *const ev = &e->xunmap;
+  const Window w = ev->window;
+
+  // Every unmap is reported to the window and to its parent, only the copy of the parent is handled
+  if (ev->event == w)
+    return;
   NeuroClientPtrPtr c = NeuroClientFindWindow(w);
+  if (c && !ev->send_event && NEURO_CLIENT_PTR(c)->info->unmap_ignores > 0U) {
+    --NEURO_CLIENT_PTR(c)->info->unmap_ignores;
+    return;
+  }
   if (c) {
+    NeuroSystemSetWmState(w, WithdrawnState);
+    NeuroWorkspaceReleaseClient(NEURO_CLIENT_PTR(c));
     NeuroEventUnmanageClient(c);
   } else {
     NeuroClient *cli = NeuroCoreRemoveMinimizedClient(w);
+    NeuroWorkspaceReleaseClient(cli);
     NeuroTypeDeleteClient(cli);
   }
-  NeuroDzenRefresh(true);
+  refresh_panels(NEURO_DZEN_CHANGE_STACK | NEURO_DZEN_CHANGE_TITLE);
 }
 
 static void do_enter_notify(XEvent *e) {
   assert(e);
   const XCrossingEvent *const ev = &e->xcrossing;
+  if (NeuroSystemIsIgnoredCrossing(ev->serial))
+    return;
   if ((ev->mode != NotifyNormal || ev->detail == NotifyInferior) && ev->window != NeuroSystemGetRoot())
     return;
   NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
@@ -116,19 +199,25 @@ static void do_enter_notify(XEvent *e) {
     return;
 
   // Do not focus if there is a fullscreen client in the stack
-  if (NeuroCoreStackFindClient(client->ws, NeuroClientTesterFullscreen, NULL))
+  if (NeuroCoreStackGetAttributeNum(client->ws, NEURO_CORE_ATTRIBUTE_FULLSCREEN) > 0U)
     return;
 
   // Focus the client
   NeuroWorkspaceUnfocus(NeuroCoreGetCurrStack());
   NeuroCoreSetCurrStack(client->ws);
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroDzenRefresh(true);
+  refresh_panels(NEURO_DZEN_CHANGE_WORKSPACE | NEURO_DZEN_CHANGE_TITLE);
 }
 
+// Note: managed clients never get their request applied as is, they are configured by the window manager
 static void do_configure_request(XEvent *e) {
   assert(e);
   const XConfigureRequestEvent *const ev = &e->xconfigurerequest;
+  NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
+  if (c) {
+    NeuroClientConfigure(c, ev);
+    return;
+  }
 
   XWindowChanges wc;
   wc.x = ev->x;
@@ -139,13 +228,6 @@ static void do_configure_request(XEvent *e) {
   wc.stack_mode = ev->detail;
   wc.border_width = ev->border_width;
   XConfigureWindow(NeuroSystemGetDisplay(), ev->window, ev->value_mask, &wc);
-  NeuroClientPtrPtr c = NeuroClientFindWindow(ev->window);
-  if (c) {
-    const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-    NeuroLayoutRunCurr(ws);
-    NeuroWorkspaceUpdate(ws);
-  }
-  NeuroDzenRefresh(true);
 }
 
 static void do_focus_in(XEvent *e) {
@@ -157,7 +239,7 @@ static void do_focus_in(XEvent *e) {
     return;
 
   NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
-  NeuroDzenRefresh(true);
+  refresh_panels(NEURO_DZEN_CHANGE_TITLE);
 }
 
 static void do_client_message(XEvent *e) {
@@ -175,10 +257,11 @@ static void do_client_message(XEvent *e) {
       NeuroClientFullscreen(c, NULL);
     else if (e->xclient.data.l[0] == 2)  // _NET_WM_STATE_TOGGLE
       NeuroClientToggleFullscreen(c, NULL);
+    refresh_panels(NEURO_DZEN_CHANGE_STACK);
   } else if (e->xclient.message_type == NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_ACTIVE)) {
     NeuroWorkspaceClientFocus(c, NeuroClientSelectorSelf, NULL);
+    refresh_panels(NEURO_DZEN_CHANGE_WORKSPACE | NEURO_DZEN_CHANGE_TITLE);
   }
-  NeuroDzenRefresh(true);
 }
 
 static void do_property_notify(XEvent *e) {
@@ -192,6 +275,7 @@ static void do_property_notify(XEvent *e) {
       return;
 
     NeuroClientUpdateTitle(c, NULL);
+    refresh_panels(NEURO_DZEN_CHANGE_TITLE);
   }
 
   // Update urgency hint
@@ -212,9 +296,8 @@ static void do_property_notify(XEvent *e) {
       XFree(wmh);
 
     NeuroClientUpdate(c, NULL);
+    refresh_panels(NEURO_DZEN_CHANGE_URGENCY);
   }
-
-  NeuroDzenRefresh(true);
 }
 
 
@@ -225,6 +308,7 @@ static void do_property_notify(XEvent *e) {
 static const NeuroEventHandlerFn event_handlers_[ LASTEvent ] = {
   [ KeyPress ] = do_key_press,
   [ ButtonPress ] = do_button_press,
+  [ MappingNotify ] = do_mapping_notify,
   [ MapRequest ] = do_map_request,
   [ UnmapNotify ] = do_unmap_notify,
   [ DestroyNotify ] = do_destroy_notify,
@@ -241,62 +325,27 @@ static const NeuroEventHandlerFn event_handlers_[ LASTEvent ] = {
 //----------------------------------------------------------------------------------------------------------------------
 
 NeuroEventHandlerFn NeuroEventGetHandler(NeuroEventType t) {
-  return event_handlers_[ t ];
+  return t < LASTEvent ? event_handlers_[ t ] : NULL;
 }
 
 void NeuroEventManageWindow(Window w) {
-  // Check if window is valid
-  XWindowAttributes wa;
-  if (!XGetWindowAttributes(NeuroSystemGetDisplay(), w, &wa))
-    return;
-  if (wa.override_redirect)
-    return;
   if (NeuroClientFindWindow(w))
     return;
 
-  // Add client to the stack list
-  NeuroClient *const cli = NeuroRuleNewClient(w, &wa);
-  if (!cli)
-    NeuroSystemError(__func__, "Could not alloc NeuroClient and set rules");
-  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
-  if (!c)
-    NeuroSystemError(__func__, "Could not add client");
-
-  // Transient windows
-  NeuroClient *const client = NEURO_CLIENT_PTR(c);
-  Window trans = None;
-  if (XGetTransientForHint(NeuroSystemGetDisplay(), client->win, &trans)) {
-    client->free_setter_fn = NeuroRuleFreeSetterFit;
-    NeuroClientPtrPtr t = NeuroClientFindWindow(trans);
-    if (t)
-      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreClientGetRegion(t));
-    else
-      NeuroGeometryRectangleCenter(NeuroCoreClientGetRegion(c), NeuroCoreStackGetRegion(client->ws));
-  }
-
-  // Run layout and update ws focus
-  NeuroWorkspaceRemoveEnterNotifyMask(client->ws);
-
-  NeuroLayoutRunCurr(client->ws);
-  XSelectInput(NeuroSystemGetDisplay(), client->win, NEURO_SYSTEM_CLIENT_MASK);
-  NeuroSystemGrabButtons(client->win, NeuroConfigGet()->button_list);
-  XMapWindow(NeuroSystemGetDisplay(), client->win);
-  NeuroWorkspaceUpdate(client->ws);
-  NeuroWorkspaceFocus(client->ws);
-
-  NeuroWorkspaceAddEnterNotifyMask(client->ws);
+  // Fetch the window attributes and properties with a single round trip
+  NeuroFetchedWindow *const fw = NeuroFetchWindows(&w, 1U);
+  if (!fw)
+    NeuroSystemError(__func__, "Could not fetch window");
+  manage_fetched_window(fw);
+  NeuroFetchFreeWindows(fw, 1U);
 }
 
 void NeuroEventUnmanageClient(NeuroClientPtrPtr c) {
   assert(c);
   const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
-  NeuroWorkspaceRemoveEnterNotifyMask(ws);
   NeuroClient *cli = NeuroCoreRemoveClient(c);
   NeuroTypeDeleteClient(cli);
-  NeuroLayoutRunCurr(ws);
-  NeuroWorkspaceUpdate(ws);
-  NeuroWorkspaceFocus(ws);
-  NeuroWorkspaceAddEnterNotifyMask(ws);
+  request_relayout(ws);
 }
 
 void NeuroEventLoadWindows(void) {
@@ -306,19 +355,45 @@ void NeuroEventLoadWindows(void) {
   if (!XQueryTree(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), &d1, &d2, &wins, &num))
     NeuroSystemError(__func__, "Could not get windows");
 
+  // Fetch the attributes and properties of all windows at once
+  NeuroFetchedWindow *const fws = NeuroFetchWindows(wins, num);
+  if (!fws)
+    NeuroSystemError(__func__, "Could not fetch windows");
+
   // Manage the windows
   for (unsigned int i = 0; i < num; ++i) {
-    XWindowAttributes wa;
-    if (!XGetWindowAttributes(NeuroSystemGetDisplay(), wins[ i ], &wa))
-      continue;
-
-    if (wa.map_state != IsViewable)
+    // Windows unmapped by a hide mode are Iconic
+    long state = WithdrawnState;
+    if (!fws[ i ].has_attributes || (fws[ i ].wa.map_state != IsViewable &&
+        !(NeuroFetchGetWmState(&state, fws + i) && state == IconicState)))
       continue;
-
-    NeuroEventManageWindow(wins[ i ]);
+    manage_fetched_window(fws + i);
   }
 
+  NeuroFetchFreeWindows(fws, num);
   if (wins)
     XFree(wins);
 }
 
+void NeuroEventBeginBatch(void) {
+  is_batching_ = true;
+}
+
+void NeuroEventEndBatch(void) {
+  is_batching_ = false;
+
+  // Run layout, update and focus once per dirty stack
+  const NeuroIndex size = NeuroCoreGetSize();
+  for (NeuroIndex ws = 0U; ws < size; ++ws) {
+    if (!NeuroCoreStackIsRelayoutPending(ws))
+      continue;
+    NeuroCoreStackSetRelayoutPending(ws, false);
+    relayout_stack(ws);
+  }
+
+  // Refresh the panels depending on the changed inputs once
+  NeuroDzenRefreshChanges(panel_changes_);
+  panel_changes_ = NEURO_DZEN_CHANGE_NULL;
+
+  NeuroClientFlushUpdates();
+}
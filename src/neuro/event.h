@@ -36,4 +36,6 @@ NeuroEventHandlerFn NeuroEventGetHandler(NeuroEventType t);
 void NeuroEventManageWindow(Window w);
 void NeuroEventUnmanageClient(NeuroClientPtrPtr c);
 void NeuroEventLoadWindows(void);
+void NeuroEventBeginBatch(void);
+void NeuroEventEndBatch(void);
 
@@ -0,0 +1,312 @@
+//----------------------------------------------------------------------------------------------------------------------
+// Module      :  fetch
+// Copyright   :  (c) Julian Bouzas 2014
+// License     :  BSD3-style (see LICENSE)
+// Maintainer  :  Julian Bouzas - nnoell3[at]gmail.com
+// Stability   :  stable
+//----------------------------------------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PREPROCESSOR
+//----------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "fetch.h"
+#include "system.h"
+#include <X11/Xlibint.h>
+
+// Defines
+#define FETCH_PROPERTY_LENGTH_MAX 1024L
+#define FETCH_SIZE_HINTS_OLD_NUM 15UL
+#define FETCH_SIZE_HINTS_NUM 18UL
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// FetchRequest (requests issued per window, in order)
+enum FetchRequest {
+  FETCH_REQUEST_ATTRIBUTES = 0,
+  FETCH_REQUEST_GEOMETRY,
+  FETCH_REQUEST_PROPERTY,
+  FETCH_REQUEST_END = FETCH_REQUEST_PROPERTY + NEURO_FETCH_PROPERTY_END
+};
+typedef enum FetchRequest FetchRequest;
+
+// FetchState (data of the async handler)
+typedef struct FetchState FetchState;
+struct FetchState {
+  NeuroFetchedWindow *fws;
+  unsigned long first_request;  // Sequence number of the first request
+  unsigned long num_requests;
+  unsigned char *replies;       // Attributes and geometry replies received per window, one bit each
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Length in 32-bit units requested for every property
+static const long property_lengths_[ NEURO_FETCH_PROPERTY_END ] = {
+  (long)FETCH_SIZE_HINTS_NUM,
+  FETCH_PROPERTY_LENGTH_MAX,
+  FETCH_PROPERTY_LENGTH_MAX,
+  FETCH_PROPERTY_LENGTH_MAX,
+  1L,
+  2L
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE FUNCTION DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+static Atom get_property_atom(NeuroFetchProperty p) {
+  switch (p) {
+    case NEURO_FETCH_PROPERTY_NORMAL_HINTS: return XA_WM_NORMAL_HINTS;
+    case NEURO_FETCH_PROPERTY_CLASS: return XA_WM_CLASS;
+    case NEURO_FETCH_PROPERTY_NET_NAME: return NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_NAME);
+    case NEURO_FETCH_PROPERTY_NAME: return XA_WM_NAME;
+    case NEURO_FETCH_PROPERTY_TRANSIENT_FOR: return XA_WM_TRANSIENT_FOR;
+    case NEURO_FETCH_PROPERTY_WM_STATE: return NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_STATE);
+    case NEURO_FETCH_PROPERTY_END: default: return None;
+  }
+}
+
+static const uint32_t *get_card32_property(const NeuroFetchedWindow *fw, NeuroFetchProperty p, unsigned long min) {
+  assert(fw);
+  const XTextProperty *const tp = fw->properties + p;
+  if (!tp->value || tp->format != 32 || tp->nitems < min)
+    return NULL;
+  return (const uint32_t *)(const void *)tp->value;
+}
+
+// Note: the display must be locked, the Xlib request macros expect it to be named 'dpy'
+// Note: it returns false if Xlib could not queue a request, the requests queued before are still sent
+static bool issue_requests(Display *dpy, Window w) {
+  xResourceReq *rreq = NULL;
+  GetResReq(GetWindowAttributes, w, rreq);
+  if (!rreq)
+    return false;
+  GetResReq(GetGeometry, w, rreq);
+  if (!rreq)
+    return false;
+  for (NeuroIndex p = 0U; p < NEURO_FETCH_PROPERTY_END; ++p) {
+    xGetPropertyReq *preq = NULL;
+    GetReq(GetProperty, preq);
+    if (!preq)
+      return false;
+    preq->window = w;
+    preq->property = get_property_atom((NeuroFetchProperty)p);
+    preq->type = AnyPropertyType;
+    preq->delete = False;
+    preq->longOffset = 0L;
+    preq->longLength = property_lengths_[ p ];
+  }
+  return true;
+}
+
+static void read_attributes(Display *dpy, NeuroFetchedWindow *fw, xReply *rep, char *buf, int len) {
+  xGetWindowAttributesReply rb;
+  const xGetWindowAttributesReply *const r = (const xGetWindowAttributesReply *)(void *)_XGetAsyncReply(dpy,
+      (char *)&rb, rep, buf, len, (SIZEOF(xGetWindowAttributesReply) - SIZEOF(xReply)) >> 2, True);
+  fw->wa.map_state = r->mapState;
+  fw->wa.override_redirect = r->override;
+}
+
+static void read_geometry(Display *dpy, NeuroFetchedWindow *fw, xReply *rep, char *buf, int len) {
+  xGetGeometryReply rb;
+  const xGetGeometryReply *const r = (const xGetGeometryReply *)(void *)_XGetAsyncReply(dpy, (char *)&rb, rep, buf,
+      len, (SIZEOF(xGetGeometryReply) - SIZEOF(xReply)) >> 2, True);
+  fw->wa.x = r->x;
+  fw->wa.y = r->y;
+  fw->wa.width = r->width;
+  fw->wa.height = r->height;
+  fw->wa.border_width = r->borderWidth;
+}
+
+static void read_property(Display *dpy, XTextProperty *tp, xReply *rep, char *buf, int len) {
+  xGetPropertyReply rb;
+  const xGetPropertyReply *const r = (const xGetPropertyReply *)(void *)_XGetAsyncReply(dpy, (char *)&rb, rep, buf,
+      len, 0, False);
+  const Atom type = r->propertyType;
+  const int format = r->format;
+  const unsigned long nitems = r->nItems;
+  const unsigned long total = (unsigned long)r->length << 2;
+
+  // Discard missing or malformed properties
+  const unsigned long size = format == 8 || format == 16 || format == 32 ? nitems * (unsigned long)(format >> 3) : 0UL;
+  unsigned char *value = type != None && size <= total ? (unsigned char *)malloc(size + 1UL) : NULL;
+  _XGetAsyncData(dpy, (char *)value, buf, len, SIZEOF(xGetPropertyReply), value ? (int)size : 0, (int)total);
+  if (!value)
+    return;
+
+  value[ size ] = '\0';
+  tp->value = value;
+  tp->encoding = type;
+  tp->format = format;
+  tp->nitems = nitems;
+}
+
+// Note: errors of the adoption requests are consumed here, they only mean the window is gone or has no property
+static Bool fetch_handler(Display *dpy, xReply *rep, char *buf, int len, XPointer data) {
+  FetchState *const s = (FetchState *)(void *)data;
+  const unsigned long offset = dpy->last_request_read - s->first_request;
+  if (offset >= s->num_requests)
+    return False;
+
+  const NeuroIndex i = (NeuroIndex)(offset / FETCH_REQUEST_END);
+  const FetchRequest r = (FetchRequest)(offset % FETCH_REQUEST_END);
+  NeuroFetchedWindow *const fw = s->fws + i;
+  if (rep->generic.type == X_Error)
+    return True;
+
+  if (r < FETCH_REQUEST_PROPERTY)
+    s->replies[ i ] |= (unsigned char)(1U << r);
+  if (r == FETCH_REQUEST_ATTRIBUTES)
+    read_attributes(dpy, fw, rep, buf, len);
+  else if (r == FETCH_REQUEST_GEOMETRY)
+    read_geometry(dpy, fw, rep, buf, len);
+  else
+    read_property(dpy, fw->properties + (r - FETCH_REQUEST_PROPERTY), rep, buf, len);
+  return True;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PUBLIC FUNCTION DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Note: every request of every window is issued at once and the replies are collected with a single round trip
+NeuroFetchedWindow *NeuroFetchWindows(const Window *wins, NeuroIndex size) {
+  assert(wins || !size);
+  NeuroFetchedWindow *const fws = (NeuroFetchedWindow *)calloc(size + 1U, sizeof(NeuroFetchedWindow));
+  if (!fws)
+    return NULL;
+  for (NeuroIndex i = 0U; i < size; ++i)
+    fws[ i ].win = wins[ i ];
+  if (!size)
+    return fws;
+  unsigned char *const replies = (unsigned char *)calloc(size, sizeof(unsigned char));
+  if (!replies) {
+    free(fws);
+    return NULL;
+  }
+
+  // Install the handler that collects the replies before issuing the requests, Xlib may flush them while they are
+  // issued and the replies to the flushed requests must already find the handler
+  Display *const dpy = NeuroSystemGetDisplay();
+  FetchState s = { fws, 0UL, (unsigned long)size*FETCH_REQUEST_END, replies };
+  _XAsyncHandler async;
+  LockDisplay(dpy);
+  s.first_request = dpy->request + 1UL;
+  async.next = dpy->async_handlers;
+  async.handler = fetch_handler;
+  async.data = (XPointer)&s;
+  dpy->async_handlers = &async;
+  for (NeuroIndex i = 0U; i < size; ++i)
+    if (!issue_requests(dpy, wins[ i ]))
+      break;
+  s.num_requests = dpy->request + 1UL - s.first_request;
+  UnlockDisplay(dpy);
+
+  // Wait for every reply
+  XSync(dpy, False);
+  LockDisplay(dpy);
+  DeqAsyncHandler(dpy, &async);
+  UnlockDisplay(dpy);
+
+  for (NeuroIndex i = 0U; i < size; ++i)
+    fws[ i ].has_attributes = replies[ i ] == ((1U << FETCH_REQUEST_PROPERTY) - 1U);
+  free(replies);
+  return fws;
+}
+
+void NeuroFetchFreeWindows(NeuroFetchedWindow *fws, NeuroIndex size) {
+  if (!fws)
+    return;
+  for (NeuroIndex i = 0U; i < size; ++i)
+    for (NeuroIndex p = 0U; p < NEURO_FETCH_PROPERTY_END; ++p)
+      free(fws[ i ].properties[ p ].value);
+  free(fws);
+}
+
+// Note: it follows XGetWMNormalHints, old 15 element hints have no base size nor gravity
+bool NeuroFetchGetSizeHints(XSizeHints *dst, const NeuroFetchedWindow *fw) {
+  assert(dst);
+  assert(fw);
+  const uint32_t *const h = get_card32_property(fw, NEURO_FETCH_PROPERTY_NORMAL_HINTS, FETCH_SIZE_HINTS_OLD_NUM);
+  if (!h || fw->properties[ NEURO_FETCH_PROPERTY_NORMAL_HINTS ].encoding != XA_WM_SIZE_HINTS)
+    return false;
+
+  const bool is_new = fw->properties[ NEURO_FETCH_PROPERTY_NORMAL_HINTS ].nitems >= FETCH_SIZE_HINTS_NUM;
+  memset(dst, 0, sizeof(XSizeHints));
+  dst->flags = (long)h[ 0 ] & (USPosition|USSize|PAllHints|(is_new ? PBaseSize|PWinGravity : 0L));
+  dst->x = (int32_t)h[ 1 ];
+  dst->y = (int32_t)h[ 2 ];
+  dst->width = (int32_t)h[ 3 ];
+  dst->height = (int32_t)h[ 4 ];
+  dst->min_width = (int32_t)h[ 5 ];
+  dst->min_height = (int32_t)h[ 6 ];
+  dst->max_width = (int32_t)h[ 7 ];
+  dst->max_height = (int32_t)h[ 8 ];
+  dst->width_inc = (int32_t)h[ 9 ];
+  dst->height_inc = (int32_t)h[ 10 ];
+  dst->min_aspect.x = (int32_t)h[ 11 ];
+  dst->min_aspect.y = (int32_t)h[ 12 ];
+  dst->max_aspect.x = (int32_t)h[ 13 ];
+  dst->max_aspect.y = (int32_t)h[ 14 ];
+  if (is_new) {
+    dst->base_width = (int32_t)h[ 15 ];
+    dst->base_height = (int32_t)h[ 16 ];
+    dst->win_gravity = (int32_t)h[ 17 ];
+  }
+  return true;
+}
+
+// Note: WM_CLASS holds the name and the class as two consecutive null terminated strings
+bool NeuroFetchGetClassHint(const char **class, const char **name, const NeuroFetchedWindow *fw) {
+  assert(class);
+  assert(name);
+  assert(fw);
+  const XTextProperty *const tp = fw->properties + NEURO_FETCH_PROPERTY_CLASS;
+  if (!tp->value || tp->format != 8 || tp->encoding != XA_STRING)
+    return false;
+  *name = (const char *)tp->value;
+  const size_t name_len = strlen(*name);
+  *class = name_len < tp->nitems ? *name + name_len + 1U : *name + name_len;
+  return true;
+}
+
+bool NeuroFetchGetTransientFor(Window *dst, const NeuroFetchedWindow *fw) {
+  assert(dst);
+  assert(fw);
+  const uint32_t *const t = get_card32_property(fw, NEURO_FETCH_PROPERTY_TRANSIENT_FOR, 1UL);
+  if (!t || fw->properties[ NEURO_FETCH_PROPERTY_TRANSIENT_FOR ].encoding != XA_WINDOW)
+    return false;
+  *dst = (Window)t[ 0 ];
+  return true;
+}
+
+bool NeuroFetchGetWmState(long *dst, const NeuroFetchedWindow *fw) {
+  assert(dst);
+  assert(fw);
+  const uint32_t *const s = get_card32_property(fw, NEURO_FETCH_PROPERTY_WM_STATE, 1UL);
+  if (!s || fw->properties[ NEURO_FETCH_PROPERTY_WM_STATE ].encoding != NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_STATE))
+    return false;
+  *dst = (long)s[ 0 ];
+  return true;
+}
+
+const XTextProperty *NeuroFetchGetTitle(const NeuroFetchedWindow *fw) {
+  assert(fw);
+  if (fw->properties[ NEURO_FETCH_PROPERTY_NET_NAME ].nitems)
+    return fw->properties + NEURO_FETCH_PROPERTY_NET_NAME;
+  if (fw->properties[ NEURO_FETCH_PROPERTY_NAME ].nitems)
+    return fw->properties + NEURO_FETCH_PROPERTY_NAME;
+  return NULL;
+}
+
@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------------------------------------------------
+// Module      :  fetch
+// Copyright   :  (c) Julian Bouzas 2014
+// License     :  BSD3-style (see LICENSE)
+// Maintainer  :  Julian Bouzas - nnoell3[at]gmail.com
+// Stability   :  stable
+//----------------------------------------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PREPROCESSOR
+//----------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+// Includes
+#include "type.h"
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// NeuroFetchProperty (window properties fetched on adoption)
+enum NeuroFetchProperty {
+  NEURO_FETCH_PROPERTY_NORMAL_HINTS = 0,
+  NEURO_FETCH_PROPERTY_CLASS,
+  NEURO_FETCH_PROPERTY_NET_NAME,
+  NEURO_FETCH_PROPERTY_NAME,
+  NEURO_FETCH_PROPERTY_TRANSIENT_FOR,
+  NEURO_FETCH_PROPERTY_WM_STATE,
+  NEURO_FETCH_PROPERTY_END
+};
+typedef enum NeuroFetchProperty NeuroFetchProperty;
+
+// NeuroFetchedWindow (replies of the adoption requests of a window)
+typedef struct NeuroFetchedWindow NeuroFetchedWindow;
+struct NeuroFetchedWindow {
+  Window win;
+  bool has_attributes;                                  // Both the attributes and the geometry were replied
+  XWindowAttributes wa;                                 // Only map_state, override_redirect and geometry are set
+  XTextProperty properties[ NEURO_FETCH_PROPERTY_END ]; // Raw reply data, value is NULL if the property is missing
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// FUNCTION DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Basic Functions
+NeuroFetchedWindow *NeuroFetchWindows(const Window *wins, NeuroIndex size);
+void NeuroFetchFreeWindows(NeuroFetchedWindow *fws, NeuroIndex size);
+
+// Parsers
+bool NeuroFetchGetSizeHints(XSizeHints *dst, const NeuroFetchedWindow *fw);
+bool NeuroFetchGetClassHint(const char **class, const char **name, const NeuroFetchedWindow *fw);
+bool NeuroFetchGetTransientFor(Window *dst, const NeuroFetchedWindow *fw);
+bool NeuroFetchGetWmState(long *dst, const NeuroFetchedWindow *fw);
+const XTextProperty *NeuroFetchGetTitle(const NeuroFetchedWindow *fw);
+
@@ -170,6 +170,21 @@ NeuroRectangle *NeuroGeometryRectangleCenter(NeuroRectangle *r, const NeuroRecta
   return r;
 }
 
+// Transform Setters
+// Note: reflecting on an axis maps p to (2*rp + rs) - p - s, mirroring swaps the axes
+NeuroTransform *NeuroGeometryTransformSetLayoutMod(NeuroTransform *t, NeuroLayoutMod mod) {
+  assert(t);
+  const bool rx = mod & NEURO_LAYOUT_MOD_REFLECTX, ry = mod & NEURO_LAYOUT_MOD_REFLECTY;
+  t->transpose = mod & NEURO_LAYOUT_MOD_MIRROR;
+  t->x_scale = rx ? -1 : 1;
+  t->x_width_scale = rx ? -1 : 0;
+  t->x_region_scale = rx ? 1 : 0;
+  t->y_scale = ry ? -1 : 1;
+  t->y_height_scale = ry ? -1 : 0;
+  t->y_region_scale = ry ? 1 : 0;
+  return t;
+}
+
 // Point-Rectangle Testers
 bool NeuroGeometryIsPointInRectangle(const NeuroRectangle *r, const NeuroPoint *p) {
   assert(r);
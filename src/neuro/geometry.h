@@ -43,6 +43,9 @@ NeuroRectangle *NeuroGeometryRectangleTranspose(NeuroRectangle *r);
 NeuroRectangle *NeuroGeometryRectangleFit(NeuroRectangle *r, const NeuroRectangle *reg);
 NeuroRectangle *NeuroGeometryRectangleCenter(NeuroRectangle *r, const NeuroRectangle *reg);
 
+// Transform Setters
+NeuroTransform *NeuroGeometryTransformSetLayoutMod(NeuroTransform *t, NeuroLayoutMod mod);
+
 // Point-Rectangle Testers
 bool NeuroGeometryIsPointInRectangle(const NeuroRectangle *r, const NeuroPoint *p);
 
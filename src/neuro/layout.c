@@ -18,21 +18,56 @@
 #include "core.h"
 #include "workspace.h"
 #include "rule.h"
+#include "client.h"
 
 // Defines
 #define STEP_SIZE_REALLOC 32
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// DenseArranger (dense version of a legacy arranger)
+typedef struct DenseArranger DenseArranger;
+struct DenseArranger {
+  const NeuroArrangerFn arranger_fn;
+  const NeuroDenseArrangerFn dense_arranger_fn;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Arrange counters
+static NeuroIndex executed_arranges_ = 0U;
+static NeuroIndex skipped_arranges_ = 0U;
+
+// Coordinates of the legacy built-in arrangers, kept between calls so they do not allocate
+static int *legacy_coords_ = NULL;
+static NeuroIndex legacy_capacity_ = 0U;
+
+// Built-in arrangers, so that configs using the legacy ones also run the dense versions
+static const DenseArranger dense_arrangers_[] = {
+  { NeuroLayoutArrangerTall, NeuroLayoutDenseArrangerTall },
+  { NeuroLayoutArrangerGrid, NeuroLayoutDenseArrangerGrid },
+  { NeuroLayoutArrangerFull, NeuroLayoutDenseArrangerFull },
+  { NeuroLayoutArrangerFloat, NeuroLayoutDenseArrangerFloat }
+};
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
-static NeuroArrange *new_arrange(NeuroIndex ws, NeuroLayout *l) {
+static NeuroArrange *get_arrange(NeuroIndex ws, NeuroLayout *l) {
   if (!l)
     return NULL;
 
-  // Allocate a new arrange
-  NeuroArrange *const a = (NeuroArrange *)malloc(sizeof(NeuroArrange));
+  // Get the arrange of the stack, big enough for all its clients
+  const NeuroIndex n = NeuroCoreStackGetSize(ws);
+  NeuroArrange *const a = NeuroCoreStackGetArrange(ws, n);
   if (!a)
     return NULL;
 
@@ -40,9 +75,12 @@ static NeuroArrange *new_arrange(NeuroIndex ws, NeuroLayout *l) {
   NeuroGeometryRectangleGetRelative(&a->region, NeuroCoreStackGetRegion(ws), l->region);
 
   // Set the clients
-  NeuroRectangle **rs = NULL, **frs = NULL;
-  NeuroIndex i = 0U, size = 0U;
-  for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c)) {
+  NeuroRectangle **const rs = a->client_regions, **const frs = a->client_float_regions;
+  NeuroRectangle *const regions = NeuroCoreStackGetClientRegions(ws);
+  NeuroIndex i = 0U;
+  for (NeuroIndex j = 0U; j < n; ++j) {
+    const NeuroClientPtrPtr c = NeuroCoreStackGetClient(ws, j);
+
     // Skip free and fullscreen clients
     if (NEURO_CLIENT_PTR(c)->free_setter_fn != NeuroRuleFreeSetterNull || NEURO_CLIENT_PTR(c)->is_fullscreen)
       continue;
@@ -53,40 +91,18 @@ static NeuroArrange *new_arrange(NeuroIndex ws, NeuroLayout *l) {
       continue;
     }
 
-    // Realloc if memory is needed
-    if (i >= size || i <= 0) {
-      size += STEP_SIZE_REALLOC;
-      rs = (NeuroRectangle **)realloc(rs, size*sizeof(void *));
-      frs = (NeuroRectangle **)realloc(frs, size*sizeof(void *));
-      if (!rs || !frs)
-        return NULL;
-    }
-
     // Set rs and frs arrays
-    rs[ i ] = NeuroCoreClientGetRegion(c);
+    rs[ i ] = regions + j;
     frs[ i ] = &(NEURO_CLIENT_PTR(c)->float_region);
     ++i;
   }
 
   // Complete the arrange
   a->size = i;
-  a->client_regions = rs;
-  a->client_float_regions = frs;
   a->parameters = l->parameters;
   return a;
 }
 
-static void delete_arrange(NeuroArrange *a) {
-  if (!a)
-    return;
-  free(a->client_regions);
-  a->client_regions = NULL;
-  free(a->client_float_regions);
-  a->client_float_regions = NULL;
-  free(a);
-  a = NULL;
-}
-
 static void get_best_positions_and_sizes(NeuroIndex n, int total, int *positions, int *sizes) {
   assert(positions);
   assert(sizes);
@@ -101,70 +117,179 @@ static void get_best_positions_and_sizes(NeuroIndex n, int total, int *positions
   }
 }
 
-// NeuroArrange runners
-static NeuroArrange *normal_arrange(NeuroArrange *a, NeuroArrangerFn af) {
+static NeuroDenseArrange *get_dense_arrange(NeuroIndex ws, const NeuroArrange *a) {
   assert(a);
-  assert(af);
-  af(a);
-  return a;
+  NeuroDenseArrange *const d = NeuroCoreStackGetDenseArrange(ws, a->size);
+  if (!d)
+    return NULL;
+  d->size = a->size;
+  d->region = a->region;
+  d->client_float_regions = a->client_float_regions;
+  d->parameters = a->parameters;
+  return d;
+}
+
+static NeuroDenseArrangerFn get_dense_arranger(const NeuroLayout *l) {
+  assert(l);
+  if (l->dense_arranger_fn)
+    return l->dense_arranger_fn;
+  for (NeuroIndex i = 0U; i < sizeof(dense_arrangers_)/sizeof(DenseArranger); ++i)
+    if (dense_arrangers_[ i ].arranger_fn == l->arranger_fn)
+      return dense_arrangers_[ i ].dense_arranger_fn;
+  return NULL;
 }
 
-static NeuroArrange *mirror_arrange(NeuroArrange *a, NeuroArrangerFn af) {
+static void gather_arrange(const NeuroArrange *a, int *xs, int *ys, int *ws, int *hs) {
   assert(a);
-  assert(af);
-  NeuroGeometryRectangleTranspose(&a->region);
-  af(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleTranspose(a->client_regions[ i ]);
-  NeuroGeometryRectangleTranspose(&a->region);
-  return a;
+  for (NeuroIndex i = 0U; i < a->size; ++i) {
+    const NeuroRectangle *const r = a->client_regions[ i ];
+    xs[ i ] = r->p.x;
+    ys[ i ] = r->p.y;
+    ws[ i ] = r->w;
+    hs[ i ] = r->h;
+  }
 }
 
-// Mods
-static NeuroArrange *reflect_x_mod(NeuroArrange *a) {
+static void scatter_arrange(NeuroArrange *a, const int *xs, const int *ys, const int *ws, const int *hs) {
   assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleReflectX(a->client_regions[ i ], &a->region);
-  return a;
+  for (NeuroIndex i = 0U; i < a->size; ++i) {
+    NeuroRectangle *const r = a->client_regions[ i ];
+    r->p.x = xs[ i ];
+    r->p.y = ys[ i ];
+    r->w = ws[ i ];
+    r->h = hs[ i ];
+  }
+}
+
+static bool reserve_legacy_coords(NeuroIndex n) {
+  if (n <= legacy_capacity_)
+    return true;
+  NeuroIndex capacity = legacy_capacity_ > 0U ? 2U*legacy_capacity_ : STEP_SIZE_REALLOC;
+  while (capacity < n)
+    capacity *= 2U;
+  int *const coords = (int *)realloc(legacy_coords_, 4U*capacity*sizeof(int));
+  if (!coords)
+    return false;
+  legacy_coords_ = coords;
+  legacy_capacity_ = capacity;
+  return true;
 }
 
-static NeuroArrange *reflect_y_mod(NeuroArrange *a) {
+// Used by the legacy versions of the built-in arrangers, the regions are left as they are if there is no memory
+static NeuroArrange *run_dense_arranger(NeuroArrange *a, NeuroDenseArrangerFn daf) {
   assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i)
-    NeuroGeometryRectangleReflectY(a->client_regions[ i ], &a->region);
+  assert(daf);
+  const NeuroIndex n = a->size;
+  if (n == 0U || !reserve_legacy_coords(n))
+    return a;
+  int *const coords = legacy_coords_;
+  NeuroDenseArrange d = { n, a->region, coords, coords + n, coords + 2U*n, coords + 3U*n, a->client_float_regions,
+      a->parameters };
+  daf(&d);
+  scatter_arrange(a, d.xs, d.ys, d.ws, d.hs);
   return a;
 }
 
+// Note: applies all the layout mods while scattering, so the client regions are only written once
+static void scatter_transformed_arrange(NeuroArrange *a, const NeuroDenseArrange *d, const NeuroTransform *t) {
+  assert(a);
+  assert(d);
+  assert(t);
+  const int *const xs = t->transpose ? d->ys : d->xs, *const ys = t->transpose ? d->xs : d->ys;
+  const int *const ws = t->transpose ? d->hs : d->ws, *const hs = t->transpose ? d->ws : d->hs;
+  const int sx = t->x_scale, swx = t->x_width_scale, sy = t->y_scale, shy = t->y_height_scale;
+  const int ox = t->x_region_scale * (2 * a->region.p.x + a->region.w);
+  const int oy = t->y_region_scale * (2 * a->region.p.y + a->region.h);
+  for (NeuroIndex i = 0U; i < a->size; ++i) {
+    NeuroRectangle *const r = a->client_regions[ i ];
+    r->p.x = sx * xs[ i ] + swx * ws[ i ] + ox;
+    r->p.y = sy * ys[ i ] + shy * hs[ i ] + oy;
+    r->w = ws[ i ];
+    r->h = hs[ i ];
+  }
+}
+
+static void run_arrange(NeuroArrange *a, NeuroDenseArrange *d, const NeuroLayout *l) {
+  assert(a);
+  assert(d);
+  assert(l);
+  const bool transpose = l->transform.transpose;
+
+  // Arrange the clients in the dense arrays, the mirrored arrange is done on the transposed region
+  const NeuroDenseArrangerFn daf = get_dense_arranger(l);
+  if (daf) {
+    if (transpose)
+      NeuroGeometryRectangleTranspose(&d->region);
+    daf(d);
+  } else {
+    if (transpose)
+      NeuroGeometryRectangleTranspose(&a->region);
+    l->arranger_fn(a);
+    if (transpose)
+      NeuroGeometryRectangleTranspose(&a->region);
+    gather_arrange(a, d->xs, d->ys, d->ws, d->hs);
+  }
+
+  // Apply the mods
+  scatter_transformed_arrange(a, d, &l->transform);
+}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Note: the stack is only arranged if its generation changed since the last arrange
 void NeuroLayoutRun(NeuroIndex ws, NeuroIndex i) {
   NeuroLayout *const l = NeuroCoreStackGetLayout(ws, i);
-  NeuroArrange *const a = new_arrange(ws, l);
-  if (!a)
-    NeuroSystemError(__func__, "Could not run layout");
-  if (a->size) {  // Then run layout
-    if (l->mod & NEURO_LAYOUT_MOD_MIRROR)
-      mirror_arrange(a, l->arranger_fn);
-    else
-      normal_arrange(a, l->arranger_fn);
-    if (l->mod & NEURO_LAYOUT_MOD_REFLECTX)
-      reflect_x_mod(a);
-    if (l->mod & NEURO_LAYOUT_MOD_REFLECTY)
-      reflect_y_mod(a);
+  if (NeuroCoreStackIsArranged(ws, l)) {
+    ++skipped_arranges_;
+    return;
   }
-  delete_arrange(a);
+  ++executed_arranges_;
+
+  NeuroArrange *const a = get_arrange(ws, l);
+  NeuroDenseArrange *const d = a ? get_dense_arrange(ws, a) : NULL;
+  if (!a || !d)
+    NeuroSystemError(__func__, "Could not run layout");
+  if (a->size)  // Then run layout
+    run_arrange(a, d, l);
+  NeuroCoreStackSetArranged(ws, l);
 }
 
 void NeuroLayoutRunCurr(NeuroIndex ws) {
   NeuroLayoutRun(ws, NeuroCoreStackGetLayoutIdx(ws));
 }
 
+// Note: only layouts that arrange every client on its own (float) can arrange a single client, false means the whole
+// stack must be arranged instead
+bool NeuroLayoutRunClient(NeuroClientPtrPtr c) {
+  if (!c)
+    return false;
+  NeuroClient *const client = NEURO_CLIENT_PTR(c);
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(client->ws);
+  if (get_dense_arranger(l) != NeuroLayoutDenseArrangerFloat)
+    return false;
+  if (client->free_setter_fn != NeuroRuleFreeSetterNull || client->is_fullscreen ||
+      NeuroCoreStackGetAttributeNum(client->ws, NEURO_CORE_ATTRIBUTE_FIXED) > 0U)
+    return false;
+
+  // Arrange the client alone in the layout region
+  NeuroRectangle *region = NeuroCoreClientGetRegion(c), *float_region = &client->float_region;
+  NeuroArrange a = { 1U, { { 0, 0 }, 0, 0 }, &region, &float_region, l->parameters };
+  NeuroGeometryRectangleGetRelative(&a.region, NeuroCoreStackGetRegion(client->ws), l->region);
+  int coords[ 4 ];
+  NeuroDenseArrange d = { 1U, a.region, coords, coords + 1, coords + 2, coords + 3, a.client_float_regions,
+      a.parameters };
+  run_arrange(&a, &d, l);
+  return true;
+}
+
 void NeuroLayoutToggleMod(NeuroIndex ws, NeuroIndex i, NeuroLayoutMod mod) {
   NeuroLayout *const l = NeuroCoreStackGetLayout(ws, i);
   l->mod ^= mod;
+  NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
+  NeuroCoreStackBumpGeneration(ws);
   NeuroLayoutRun(ws, i);
   NeuroWorkspaceUpdate(ws);
 }
@@ -190,17 +315,21 @@ void NeuroLayoutChange(NeuroIndex ws, int step) {
 }
 
 void NeuroLayoutReset(NeuroIndex ws) {
+  NeuroClientBeginTransaction();
   for (NeuroIndex i = 0U; i < NeuroCoreStackGetNumLayouts(ws); ++i) {
     NeuroLayout *const l = NeuroCoreStackGetLayout(ws, i);
     const NeuroLayoutConf *const lc = NeuroCoreStackGetLayoutConf(ws, i);
     l->mod = lc->mod;
+    NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
     l->follow_mouse = lc->follow_mouse;
     memmove(l->parameters, lc->parameters, sizeof(NeuroArg)*NEURO_ARRANGE_ARGS_MAX);
   }
+  NeuroCoreStackBumpGeneration(ws);
   NeuroWorkspaceTile(ws);
   NeuroCoreStackSetLayoutIdx(ws, 0U);
   NeuroLayoutRunCurr(ws);
   NeuroWorkspaceFocus(ws);
+  NeuroClientEndTransaction();
 }
 
 void NeuroLayoutIncreaseMaster(NeuroIndex ws, int step) {
@@ -209,6 +338,7 @@ void NeuroLayoutIncreaseMaster(NeuroIndex ws, int step) {
   if (res < 1)
     return;
   as[ 0 ].int_ = res;
+  NeuroCoreStackBumpGeneration(ws);
   NeuroLayoutRunCurr(ws);
   NeuroWorkspaceFocus(ws);
 }
@@ -219,103 +349,126 @@ void NeuroLayoutResizeMaster(NeuroIndex ws, float factor) {
   if (new_master_size <= 0.0f || new_master_size >= 1.0f)
     return;
   as[ 1 ].float_ = new_master_size;
+  NeuroCoreStackBumpGeneration(ws);
   NeuroLayoutRunCurr(ws);
   NeuroWorkspaceFocus(ws);
 }
 
+NeuroIndex NeuroLayoutGetExecutedArranges(void) {
+  return executed_arranges_;
+}
+
+NeuroIndex NeuroLayoutGetSkippedArranges(void) {
+  return skipped_arranges_;
+}
+
 // NeuroLayout Arrangers
 NeuroArrange *NeuroLayoutArrangerTall(NeuroArrange *a) {
-  assert(a);
-  const NeuroIndex n = a->size, mn = a->parameters[ 0 ].idx_, nwindows = n <= mn ? n : mn;
-  const int ms = (int)(a->parameters[ 1 ].float_ * a->region.w);
-  int ys[ n ], hs[ n ];
-  memset(ys, 0, sizeof(ys));
-  memset(hs, 0, sizeof(hs));
+  return run_dense_arranger(a, NeuroLayoutDenseArrangerTall);
+}
+
+NeuroArrange *NeuroLayoutArrangerGrid(NeuroArrange *a) {
+  return run_dense_arranger(a, NeuroLayoutDenseArrangerGrid);
+}
+
+NeuroArrange *NeuroLayoutArrangerFull(NeuroArrange *a) {
+  return run_dense_arranger(a, NeuroLayoutDenseArrangerFull);
+}
+
+NeuroArrange *NeuroLayoutArrangerFloat(NeuroArrange *a) {
+  return run_dense_arranger(a, NeuroLayoutDenseArrangerFloat);
+}
+
+// NeuroLayout Dense Arrangers
+NeuroDenseArrange *NeuroLayoutDenseArrangerTall(NeuroDenseArrange *d) {
+  assert(d);
+  const NeuroIndex n = d->size, mn = d->parameters[ 0 ].idx_, nwindows = n <= mn ? n : mn;
+  const int ms = (int)(d->parameters[ 1 ].float_ * d->region.w);
+  const int x = d->region.p.x, y = d->region.p.y;
 
   // Master area
-  get_best_positions_and_sizes(nwindows, a->region.h, ys, hs);
+  get_best_positions_and_sizes(nwindows, d->region.h, d->ys, d->hs);
+  const int mw = n > mn ? ms : d->region.w;
   NeuroIndex i = 0U;
   for ( ; i < nwindows; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
-    r->p.x = a->region.p.x;
-    r->p.y = a->region.p.y + ys[ i ];
-    r->w = n > mn ? ms : a->region.w;
-    r->h = hs[ i ];
+    d->xs[ i ] = x;
+    d->ys[ i ] += y;
+    d->ws[ i ] = mw;
   }
 
   // Return if the master area has all clients
   if (n - nwindows == 0U)
-    return a;
+    return d;
 
   // Stacking area
-  get_best_positions_and_sizes(n - nwindows, a->region.h, ys, hs);
+  get_best_positions_and_sizes(n - nwindows, d->region.h, d->ys + nwindows, d->hs + nwindows);
+  const int sw = d->region.w - ms;
   for ( ; i < n; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
-    r->p.x = a->region.p.x + ms;
-    r->p.y = a->region.p.y + ys[ i-nwindows ];
-    r->w = a->region.w - ms;
-    r->h = hs[ i-nwindows ];
+    d->xs[ i ] = x + ms;
+    d->ys[ i ] += y;
+    d->ws[ i ] = sw;
   }
 
-  return a;
+  return d;
 }
 
-NeuroArrange *NeuroLayoutArrangerGrid(NeuroArrange *a) {
-  assert(a);
-  const NeuroIndex n = a->size;
+// Note: there are only two different column heights, so each partition is computed once and the grid is O(n)
+NeuroDenseArrange *NeuroLayoutDenseArrangerGrid(NeuroDenseArrange *d) {
+  assert(d);
+  const NeuroIndex n = d->size;
+  if (n == 0U)
+    return d;
   NeuroIndex cols = 0U;
   for ( ; cols <= n/2; ++cols)
     if (cols * cols >= n)
       break;
-  NeuroIndex rows = n / cols;
-  int xs[ cols ], ws[ cols ];
-  memset(xs, 0, sizeof(xs));
-  memset(ws, 0, sizeof(ws));
-
-  // Grid area
-  get_best_positions_and_sizes(cols, a->region.w, xs, ws);
-  NeuroIndex cn = 0U, rn = 0U;
-  for (NeuroIndex i = 0U; i < n; ++i) {
-    if (i/rows + 1 > cols - n%cols)
-      rows = n/cols + 1;
 
-    int ys[ rows ], hs[ rows ];
-    memset(ys, 0, sizeof(ys));
-    memset(hs, 0, sizeof(hs));
-    get_best_positions_and_sizes(rows, a->region.h, ys, hs);
+  // The first columns have n/cols rows, and the last n%cols columns have one row more
+  const NeuroIndex rows = n / cols, short_cols = cols - n%cols;
+  int xs[ cols ], ws[ cols ], ys[ rows ], hs[ rows ], long_ys[ rows + 1U ], long_hs[ rows + 1U ];
+  get_best_positions_and_sizes(cols, d->region.w, xs, ws);
+  get_best_positions_and_sizes(rows, d->region.h, ys, hs);
+  get_best_positions_and_sizes(rows + 1U, d->region.h, long_ys, long_hs);
 
-    // Update client region
-    NeuroRectangle *const r = a->client_regions[ i ];
-    r->p.x = a->region.p.x + xs[ cn ];
-    r->p.y = a->region.p.y + ys[ rn ];
-    r->w = ws[ cn ];
-    r->h = hs[ rn ];
-
-    if (++rn >= rows) {
-      rn = 0U;
-      ++cn;
+  // Grid area
+  NeuroIndex i = 0U;
+  for (NeuroIndex cn = 0U; cn < cols; ++cn) {
+    const bool is_long = cn >= short_cols;
+    const NeuroIndex col_rows = is_long ? rows + 1U : rows;
+    const int *const col_ys = is_long ? long_ys : ys, *const col_hs = is_long ? long_hs : hs;
+    const int x = d->region.p.x + xs[ cn ], y = d->region.p.y, w = ws[ cn ];
+    for (NeuroIndex rn = 0U; rn < col_rows; ++rn, ++i) {
+      d->xs[ i ] = x;
+      d->ys[ i ] = y + col_ys[ rn ];
+      d->ws[ i ] = w;
+      d->hs[ i ] = col_hs[ rn ];
     }
   }
-  return a;
+  return d;
 }
 
-NeuroArrange *NeuroLayoutArrangerFull(NeuroArrange *a) {
-  assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i) {
-    NeuroRectangle *const r = a->client_regions[ i ];
-    memmove(r, &a->region, sizeof(NeuroRectangle));
+NeuroDenseArrange *NeuroLayoutDenseArrangerFull(NeuroDenseArrange *d) {
+  assert(d);
+  const NeuroRectangle r = d->region;
+  for (NeuroIndex i = 0U; i < d->size; ++i) {
+    d->xs[ i ] = r.p.x;
+    d->ys[ i ] = r.p.y;
+    d->ws[ i ] = r.w;
+    d->hs[ i ] = r.h;
   }
-  return a;
+  return d;
 }
 
-NeuroArrange *NeuroLayoutArrangerFloat(NeuroArrange *a) {
-  assert(a);
-  for (NeuroIndex i = 0U; i < a->size; ++i) {
-    const NeuroRectangle *const fr = a->client_float_regions[ i ];
-    NeuroRectangle *const r = a->client_regions[ i ];
-    memmove(r, fr, sizeof(NeuroRectangle));
-    NeuroGeometryRectangleFit(a->client_regions[ i ], &a->region);
+NeuroDenseArrange *NeuroLayoutDenseArrangerFloat(NeuroDenseArrange *d) {
+  assert(d);
+  for (NeuroIndex i = 0U; i < d->size; ++i) {
+    NeuroRectangle r = *d->client_float_regions[ i ];
+    NeuroGeometryRectangleFit(&r, &d->region);
+    d->xs[ i ] = r.p.x;
+    d->ys[ i ] = r.p.y;
+    d->ws[ i ] = r.w;
+    d->hs[ i ] = r.h;
   }
-  return a;
+  return d;
 }
 
@@ -24,6 +24,7 @@
 // Basic functions
 void NeuroLayoutRun(NeuroIndex ws, NeuroIndex i);
 void NeuroLayoutRunCurr(NeuroIndex ws);
+bool NeuroLayoutRunClient(NeuroClientPtrPtr c);
 void NeuroLayoutToggleMod(NeuroIndex ws, NeuroIndex i, NeuroLayoutMod mod);
 void NeuroLayoutToggleModCurr(NeuroIndex ws, NeuroLayoutMod mod);
 void NeuroLayoutToggle(NeuroIndex ws, NeuroIndex i);
@@ -31,6 +32,8 @@ void NeuroLayoutChange(NeuroIndex ws, int step);
 void NeuroLayoutReset(NeuroIndex ws);
 void NeuroLayoutIncreaseMaster(NeuroIndex ws, int step);
 void NeuroLayoutResizeMaster(NeuroIndex ws, float factor);
+NeuroIndex NeuroLayoutGetExecutedArranges(void);
+NeuroIndex NeuroLayoutGetSkippedArranges(void);
 
 // NeuroLayout Arrangers
 NeuroArrange *NeuroLayoutArrangerTall(NeuroArrange *a);
@@ -38,3 +41,9 @@ NeuroArrange *NeuroLayoutArrangerGrid(NeuroArrange *a);
 NeuroArrange *NeuroLayoutArrangerFull(NeuroArrange *a);
 NeuroArrange *NeuroLayoutArrangerFloat(NeuroArrange *a);
 
+// NeuroLayout Dense Arrangers
+NeuroDenseArrange *NeuroLayoutDenseArrangerTall(NeuroDenseArrange *d);
+NeuroDenseArrange *NeuroLayoutDenseArrangerGrid(NeuroDenseArrange *d);
+NeuroDenseArrange *NeuroLayoutDenseArrangerFull(NeuroDenseArrange *d);
+NeuroDenseArrange *NeuroLayoutDenseArrangerFloat(NeuroDenseArrange *d);
+
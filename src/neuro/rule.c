@@ -21,46 +21,71 @@
 #include "workspace.h"
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// RuleKey
+typedef struct RuleKey RuleKey;
+struct RuleKey {
+  const char *class;  // Interned class of the rule, NULL if the rule does not check it
+  const char *name;   // Interned name of the rule, NULL if the rule does not check it
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Interned rule keys, one per rule in the configuration
+static RuleKey *rule_keys_ = NULL;
+static const char *scratchpad_name_ = NULL;
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+static bool is_free_size(const XSizeHints *size) {
+  assert(size);
+  int maxw = 0, maxh = 0, minw = 0, minh = 0;
+  if (size->flags & PMaxSize) {
+    maxw = size->max_width;
+    maxh = size->max_height;
+  }
+  if (size->flags & PMinSize) {
+    minw = size->min_width;
+    minh = size->min_height;
+  } else if (size->flags & PBaseSize) {
+    minw = size->base_width;
+    minh = size->base_height;
+  }
+  return maxw && minw && maxh && minh && maxw == minw && maxh == minh;
+}
+
 static bool is_free_size_hints(NeuroClient *c) {
   assert(c);
-  int maxw = 0, maxh = 0, minw = 0, minh = 0;
   long msize = 0L;
   XSizeHints size;
   if (!XGetWMNormalHints(NeuroSystemGetDisplay(), c->win, &size, &msize))
     size.flags = PSize;
-  if (size.flags & PMaxSize) {
-    maxw = size.max_width;
-    maxh = size.max_height;
-  }
-  if (size.flags & PMinSize) {
-    minw = size.min_width;
-    minh = size.min_height;
-  } else if (size.flags & PBaseSize) {
-    minw = size.base_width;
-    minh = size.base_height;
-  }
-  return maxw && minw && maxh && minh && maxw == minw && maxh == minh;
+  return is_free_size(&size);
 }
 
-static bool has_rule(const NeuroClient *c, const NeuroRule *r) {
+// Note: class and name are interned, so they are compared by pointer
+static bool has_rule(const NeuroClient *c, const NeuroRule *r, const RuleKey *k) {
   assert(c);
   assert(r);
+  assert(k);
   if (!c)
     return false;
   if (!r->class && !r->name && !r->title)
     return false;
-  bool res_class = true, res_name = true, res_title = true;
-  if (r->class)
-    res_class = strcmp(c->class, r->class) == 0;
-  if (r->name)
-    res_name = strcmp(c->name, r->name) == 0;
-  if (r->title)
-    res_title = strcmp(c->title, r->title) == 0;
-  return res_class && res_name && res_title;
+  if (k->class && c->info->class != k->class)
+    return false;
+  if (k->name && c->info->name != k->name)
+    return false;
+  return !r->title || strcmp(c->info->title, r->title) == 0;
 }
 
 static void set_rule(NeuroClient *c, const NeuroRule *r) {
@@ -78,18 +103,18 @@ static void set_rule(NeuroClient *c, const NeuroRule *r) {
 static void apply_rules(NeuroClient *c) {
   assert(c);
   const NeuroRule *const *const rule_list = NeuroConfigGet()->rule_list;
-  if (!rule_list)
+  if (!rule_list || !rule_keys_)
     return;
 
   for (NeuroIndex i = 0U; rule_list[ i ]; ++i) {
     const NeuroRule *r = rule_list[ i ];
-    if (has_rule(c, r)) {
+    if (has_rule(c, r, rule_keys_ + i)) {
       set_rule(c, r);
       break;
     }
   }
 
-  if (!strcmp(c->name, NEURO_RULE_SCRATCHPAD_NAME))
+  if (c->info->name == scratchpad_name_)
     c->is_nsp = true;
 }
 
@@ -98,6 +123,36 @@ static void apply_rules(NeuroClient *c) {
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Note: the keys are interned by the core, so it must be initialized before and stopped after this module
+bool NeuroRuleInit(void) {
+  scratchpad_name_ = NeuroCoreInternString(NEURO_RULE_SCRATCHPAD_NAME);
+  if (!scratchpad_name_)
+    return false;
+
+  const NeuroRule *const *const rule_list = NeuroConfigGet()->rule_list;
+  if (!rule_list)
+    return true;
+  const NeuroIndex size = NeuroTypeArrayLength((const void *const *)rule_list);
+  rule_keys_ = (RuleKey *)calloc(size + 1U, sizeof(RuleKey));
+  if (!rule_keys_)
+    return false;
+
+  for (NeuroIndex i = 0U; i < size; ++i) {
+    const NeuroRule *const r = rule_list[ i ];
+    rule_keys_[ i ].class = NeuroCoreInternString(r->class);
+    rule_keys_[ i ].name = NeuroCoreInternString(r->name);
+    if ((r->class && !rule_keys_[ i ].class) || (r->name && !rule_keys_[ i ].name))
+      return false;
+  }
+  return true;
+}
+
+void NeuroRuleStop(void) {
+  free(rule_keys_);
+  rule_keys_ = NULL;
+  scratchpad_name_ = NULL;
+}
+
 NeuroClient *NeuroRuleNewClient(Window w, const XWindowAttributes *wa) {
   if (!wa)
     return NULL;
@@ -115,6 +170,29 @@ NeuroClient *NeuroRuleNewClient(Window w, const XWindowAttributes *wa) {
   return c;
 }
 
+// Note: same as NeuroRuleNewClient but without round trips, the properties were already fetched
+NeuroClient *NeuroRuleNewFetchedClient(const NeuroFetchedWindow *fw) {
+  if (!fw || !fw->has_attributes)
+    return NULL;
+
+  NeuroClient *c = NeuroTypeNewClient(fw->win, &fw->wa);
+  if (!c)
+    return NULL;
+
+  XSizeHints size;
+  if (!NeuroFetchGetSizeHints(&size, fw))
+    size.flags = PSize;
+  if (is_free_size(&size))
+    c->free_setter_fn = NeuroRuleFreeSetterCenter;
+  c->ws = NeuroCoreGetCurrStack();
+  const char *class = NULL, *name = NULL;
+  if (NeuroFetchGetClassHint(&class, &name, fw))
+    NeuroClientSetClassAndName(&c, class, name);
+  NeuroClientSetTitle(&c, NeuroFetchGetTitle(fw));
+  apply_rules(c);
+  return c;
+}
+
 void NeuroRuleSetLayoutRegion(NeuroRectangle *r, const NeuroClientPtrPtr c) {
   if (!r || !c || NEURO_CLIENT_PTR(c)->fixed_pos == NEURO_FIXED_POSITION_NULL)
     return;
@@ -15,6 +15,7 @@
 
 // Includes
 #include "type.h"
+#include "fetch.h"
 
 // Defines
 #define NEURO_RULE_SCRATCHPAD_NAME "neurowm_scratchpad"
@@ -26,7 +27,10 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 // Basic Functions
+bool NeuroRuleInit(void);
+void NeuroRuleStop(void);
 NeuroClient *NeuroRuleNewClient(Window w, const XWindowAttributes *wa);
+NeuroClient *NeuroRuleNewFetchedClient(const NeuroFetchedWindow *fw);
 void NeuroRuleSetLayoutRegion(NeuroRectangle *r, const NeuroClientPtrPtr c);
 void NeuroRuleSetClientRegion(NeuroRectangle *r, const NeuroClientPtrPtr c);
 
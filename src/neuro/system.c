@@ -15,6 +15,31 @@
 #include "system.h"
 #include "config.h"
 
+// Defines
+#define BINDING_TABLE_SIZE 256  // Keycodes and buttons fit in a byte
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Binding (entry of a dispatch table)
+typedef struct Binding Binding;
+struct Binding {
+  unsigned int code;    // Keycode or button
+  unsigned int mod;     // Cleaned modifier mask
+  const void *binding;  // NeuroKey or NeuroButton
+  NeuroIndex next;      // Next entry with the same code plus one, 0 ends the chain
+};
+
+// BindingTable (bindings chained by code, in list order)
+typedef struct BindingTable BindingTable;
+struct BindingTable {
+  NeuroIndex heads[ BINDING_TABLE_SIZE ];  // First entry of every code plus one
+  Binding *bindings;
+  NeuroIndex size;
+};
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE VARIABLE DEFINITION
@@ -32,6 +57,19 @@ static Atom wm_atoms_[ NEURO_SYSTEM_WMATOM_END ];
 static Atom net_atoms_[ NEURO_SYSTEM_NETATOM_END ];
 static NeuroColor colors_[ NEURO_SYSTEM_COLOR_END ];
 
+// Crossing events with an older serial were caused by the window manager
+static unsigned long crossing_serial_ = 0UL;
+
+// Sync extension
+static bool has_sync_ = false;
+static int sync_event_base_ = 0;
+static int sync_error_base_ = 0;
+
+// Bindings
+static unsigned int numlock_mask_ = 0U;
+static BindingTable key_table_;
+static BindingTable button_table_;
+
 // Version
 static const char *const version_ = PKG_NAME " " PKG_VERSION;
 
@@ -49,6 +87,7 @@ static const char *const recompile_cmd_[] = {
   "-l" PKG_NAME,
   "-lX11",
   "-lXrandr",
+  "-lXext",
   "-pthread",
   NULL
 };
@@ -79,12 +118,68 @@ static int xerror_handler(Display *d, XErrorEvent *ee) {
       || (ee->request_code == X_GrabButton        && ee->error_code == BadAccess)
       || (ee->request_code == X_GrabKey           && ee->error_code == BadAccess)
       || (ee->request_code == X_CopyArea          && ee->error_code == BadDrawable)
-      || (ee->request_code == X_KillClient        && ee->error_code == BadValue))
+      || (ee->request_code == X_KillClient        && ee->error_code == BadValue)
+      || (has_sync_ && ee->error_code == sync_error_base_ + XSyncBadCounter)
+      || (has_sync_ && ee->error_code == sync_error_base_ + XSyncBadAlarm))
     return 0;
   printf("error: Request code=%d, error code=%d\n", ee->request_code, ee->error_code);
   return -1;
 }
 
+static void update_numlock_mask(void) {
+  numlock_mask_ = 0U;
+  const KeyCode numlock = XKeysymToKeycode(display_, XK_Num_Lock);
+  XModifierKeymap *const mm = XGetModifierMapping(display_);
+  if (!mm)
+    return;
+  for (int i = 0; numlock && i < 8; ++i)
+    for (int j = 0; j < mm->max_keypermod; ++j)
+      if (mm->modifiermap[ i*mm->max_keypermod + j ] == numlock)
+        numlock_mask_ = 1U << i;
+  XFreeModifiermap(mm);
+}
+
+static bool reset_binding_table(BindingTable *t, NeuroIndex capacity) {
+  assert(t);
+  Binding *const bindings = (Binding *)realloc(t->bindings, (capacity ? capacity : 1U)*sizeof(Binding));
+  if (!bindings)
+    return false;
+  t->bindings = bindings;
+  t->size = 0U;
+  memset(t->heads, 0, sizeof(t->heads));
+  return true;
+}
+
+// Note: Bindings must be added in reverse list order, so that the chains keep the list order
+static void add_binding(BindingTable *t, unsigned int code, unsigned int mod, const void *binding) {
+  assert(t);
+  NeuroIndex *const head = t->heads + (code % BINDING_TABLE_SIZE);
+  t->bindings[ t->size ] = (Binding){ code, NeuroSystemCleanMask(mod), binding, *head };
+  *head = ++t->size;
+}
+
+static NeuroIndex find_bindings(const BindingTable *t, const void **dst, unsigned int code, unsigned int mod) {
+  assert(t);
+  assert(dst);
+  const unsigned int clean_mod = NeuroSystemCleanMask(mod);
+  NeuroIndex n = 0U;
+  for (NeuroIndex i = t->heads[ code % BINDING_TABLE_SIZE ]; i && n < NEURO_SYSTEM_BINDING_MATCH_MAX; ) {
+    const Binding *const b = t->bindings + i - 1U;
+    if (b->code == code && b->mod == clean_mod)
+      dst[ n++ ] = b->binding;
+    i = b->next;
+  }
+  return n;
+}
+
+static void free_binding_table(BindingTable *t) {
+  assert(t);
+  free(t->bindings);
+  t->bindings = NULL;
+  t->size = 0U;
+  memset(t->heads, 0, sizeof(t->heads));
+}
+
 static bool set_colors_cursors_atoms(void) {
   if (!NeuroConfigGet()->normal_border_color || !NeuroConfigGet()->current_border_color ||
       !NeuroConfigGet()->old_border_color || !NeuroConfigGet()->free_border_color ||
@@ -106,6 +201,7 @@ static bool set_colors_cursors_atoms(void) {
   // WM Atoms
   wm_atoms_[ NEURO_SYSTEM_WMATOM_PROTOCOLS ] = XInternAtom(display_, "WM_PROTOCOLS", false);
   wm_atoms_[ NEURO_SYSTEM_WMATOM_DELETEWINDOW ] = XInternAtom(display_, "WM_DELETE_WINDOW", false);
+  wm_atoms_[ NEURO_SYSTEM_WMATOM_STATE ] = XInternAtom(display_, "WM_STATE", false);
 
   // Net Atoms
   net_atoms_[ NEURO_SYSTEM_NETATOM_SUPPORTED ] = XInternAtom(display_, "_NET_SUPPORTED", false);
@@ -115,6 +211,9 @@ static bool set_colors_cursors_atoms(void) {
   net_atoms_[ NEURO_SYSTEM_NETATOM_FULLSCREEN ] = XInternAtom(display_, "_NET_WM_STATE_FULLSCREEN", false);
   net_atoms_[ NEURO_SYSTEM_NETATOM_STRUT ] = XInternAtom(display_, "_NET_WM_STRUT", false);
   net_atoms_[ NEURO_SYSTEM_NETATOM_CLOSEWINDOW ] = XInternAtom(display_, "_NET_CLOSE_WINDOW", false);
+  net_atoms_[ NEURO_SYSTEM_NETATOM_SYNC_REQUEST ] = XInternAtom(display_, "_NET_WM_SYNC_REQUEST", false);
+  net_atoms_[ NEURO_SYSTEM_NETATOM_SYNC_REQUEST_COUNTER ] = XInternAtom(display_, "_NET_WM_SYNC_REQUEST_COUNTER",
+      false);
 
   // EWMH support per view
   XChangeProperty(display_, root_, net_atoms_[ NEURO_SYSTEM_NETATOM_SUPPORTED ], XA_ATOM, 32, PropModeReplace,
@@ -128,6 +227,11 @@ static void run_command(const char *const *cmd) {
   assert(cmd);
   assert(*cmd);
 
+  // The event loop blocks the signals it reads through a signalfd, the command must not inherit them
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigprocmask(SIG_SETMASK, &mask, NULL);
+
   // Create a new command in order to avoid const correctness issues in execvp 2nd parameter
   const NeuroIndex size = NeuroTypeArrayLength((const void *const *)cmd) + 1;  // We need an extra slot for NULL
   char **command = (char **)calloc(size, sizeof(void *));
@@ -184,6 +288,11 @@ bool NeuroSystemInit(void) {
   if (!set_colors_cursors_atoms())
     return false;
 
+  // Clients that support _NET_WM_SYNC_REQUEST are only resized through the sync extension
+  int sync_major = 0, sync_minor = 0;
+  has_sync_ = XSyncQueryExtension(display_, &sync_event_base_, &sync_error_base_) &&
+      XSyncInitialize(display_, &sync_major, &sync_minor);
+
   // Check if another window manager is already running
   XSetErrorHandler(xerror_handler_start);
 
@@ -199,13 +308,17 @@ bool NeuroSystemInit(void) {
   XSetErrorHandler(xerror_handler);
   XSync(display_, false);
 
-  // Grab key bindings
+  // Build the binding dispatch tables and grab key bindings
+  if (!NeuroSystemUpdateBindings())
+    return false;
   NeuroSystemGrabKeys(root_, NeuroConfigGet()->key_list);
 
   return true;
 }
 
 void NeuroSystemStop(void) {
+  free_binding_table(&key_table_);
+  free_binding_table(&button_table_);
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_NORMAL));
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_RESIZE));
   XFreeCursor(display_, NeuroSystemGetCursor(NEURO_SYSTEM_CURSOR_MOVE));
@@ -258,6 +371,31 @@ Atom NeuroSystemGetNetAtom(NeuroSystemNetatom a) {
   return net_atoms_[ a ];
 }
 
+// Note: state is one of WithdrawnState, NormalState or IconicState, the icon window is always None
+void NeuroSystemSetWmState(Window w, long state) {
+  const long data[] = { state, None };
+  XChangeProperty(display_, w, wm_atoms_[ NEURO_SYSTEM_WMATOM_STATE ], wm_atoms_[ NEURO_SYSTEM_WMATOM_STATE ], 32,
+      PropModeReplace, (const unsigned char *)data, 2);
+}
+
+// Note: the no-op request makes crossing events caused by the user afterwards have a newer serial
+void NeuroSystemIgnoreCrossing(void) {
+  crossing_serial_ = NextRequest(display_);
+  XNoOp(display_);
+}
+
+bool NeuroSystemIsIgnoredCrossing(unsigned long serial) {
+  return serial < crossing_serial_;
+}
+
+bool NeuroSystemHasSync(void) {
+  return has_sync_;
+}
+
+int NeuroSystemGetSyncEventBase(void) {
+  return sync_event_base_;
+}
+
 NeuroColor NeuroSystemGetColor(NeuroSystemColor c) {
   return colors_[ c ];
 }
@@ -372,47 +510,114 @@ void NeuroSystemError(const char *function_name, const char *msg) {
 }
 
 // Binding functions
+// Note: Must be called at startup and after every MappingNotify, it is the only place doing round trips
+bool NeuroSystemUpdateBindings(void) {
+  update_numlock_mask();
+  return NeuroSystemUpdateKeyBindings(NeuroConfigGet()->key_list) &&
+      NeuroSystemUpdateButtonBindings(NeuroConfigGet()->button_list);
+}
+
+bool NeuroSystemUpdateKeyBindings(const NeuroKey *const *key_list) {
+  const NeuroIndex size = key_list ? NeuroTypeArrayLength((const void *const *)key_list) : 0U;
+  if (!reset_binding_table(&key_table_, size))
+    return false;
+  for (NeuroIndex i = size; i > 0U; --i) {
+    const NeuroKey *const k = key_list[ i - 1U ];
+    const KeyCode code = XKeysymToKeycode(display_, k->key);
+    if (code)
+      add_binding(&key_table_, code, k->mod, k);
+  }
+  return true;
+}
+
+bool NeuroSystemUpdateButtonBindings(const NeuroButton *const *button_list) {
+  const NeuroIndex size = button_list ? NeuroTypeArrayLength((const void *const *)button_list) : 0U;
+  if (!reset_binding_table(&button_table_, size))
+    return false;
+  for (NeuroIndex i = size; i > 0U; --i) {
+    const NeuroButton *const b = button_list[ i - 1U ];
+    add_binding(&button_table_, b->button, b->mod, b);
+  }
+  return true;
+}
+
+// Note: Lock and NumLock are ignored, so they do not need duplicate bindings
+unsigned int NeuroSystemCleanMask(unsigned int mod) {
+  return mod & ~(numlock_mask_|LockMask) & NEURO_SYSTEM_MODIFIER_MASK;
+}
+
+// Note: dst must hold NEURO_SYSTEM_BINDING_MATCH_MAX keys, they are returned in list order
+NeuroIndex NeuroSystemFindKeyBindings(const NeuroKey **dst, unsigned int keycode, unsigned int mod) {
+  assert(dst);
+  const void *found[ NEURO_SYSTEM_BINDING_MATCH_MAX ];
+  const NeuroIndex n = find_bindings(&key_table_, found, keycode, mod);
+  for (NeuroIndex i = 0U; i < n; ++i)
+    dst[ i ] = (const NeuroKey *)found[ i ];
+  return n;
+}
+
+// Note: dst must hold NEURO_SYSTEM_BINDING_MATCH_MAX buttons, they are returned in list order
+NeuroIndex NeuroSystemFindButtonBindings(const NeuroButton **dst, unsigned int button, unsigned int mod) {
+  assert(dst);
+  const void *found[ NEURO_SYSTEM_BINDING_MATCH_MAX ];
+  const NeuroIndex n = find_bindings(&button_table_, found, button, mod);
+  for (NeuroIndex i = 0U; i < n; ++i)
+    dst[ i ] = (const NeuroButton *)found[ i ];
+  return n;
+}
+
 void NeuroSystemGrabKeys(Window w, const NeuroKey *const *key_list) {
   if (!key_list)
     return;
+  const unsigned int locks[] = { 0U, LockMask, numlock_mask_, numlock_mask_|LockMask };
   XUngrabKey(display_, AnyKey, AnyModifier, w);
   for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
     const NeuroKey *const k = key_list[ i ];
     const KeyCode code = XKeysymToKeycode(display_, k->key);
-    if (code)
-      XGrabKey(display_, code, k->mod, w, true, GrabModeAsync, GrabModeAsync);
+    if (!code)
+      continue;
+    for (NeuroIndex j = 0U; j < sizeof(locks)/sizeof(unsigned int); ++j)
+      XGrabKey(display_, code, k->mod | locks[ j ], w, true, GrabModeAsync, GrabModeAsync);
   }
 }
 
 void NeuroSystemUngrabKeys(Window w, const NeuroKey *const *key_list) {
   if (!key_list)
     return;
+  const unsigned int locks[] = { 0U, LockMask, numlock_mask_, numlock_mask_|LockMask };
   for (NeuroIndex i = 0U; key_list[ i ]; ++i) {
     const NeuroKey *const k = key_list[ i ];
     const KeyCode code = XKeysymToKeycode(display_, k->key);
-    if (code)
-      XUngrabKey(display_, code, k->mod, w);
+    if (!code)
+      continue;
+    for (NeuroIndex j = 0U; j < sizeof(locks)/sizeof(unsigned int); ++j)
+      XUngrabKey(display_, code, k->mod | locks[ j ], w);
   }
 }
 
 void NeuroSystemGrabButtons(Window w, const NeuroButton *const *button_list) {
   if (!button_list)
     return;
+  const unsigned int locks[] = { 0U, LockMask, numlock_mask_, numlock_mask_|LockMask };
   XUngrabButton(display_, AnyButton, AnyModifier, w);
   for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
     const NeuroButton *const b = button_list[ i ];
-    XGrabButton(display_, b->button, b->mod, w, false, ButtonPressMask|ButtonReleaseMask, GrabModeAsync, GrabModeSync,
-        None, None);
+    for (NeuroIndex j = 0U; j < sizeof(locks)/sizeof(unsigned int); ++j)
+      XGrabButton(display_, b->button, b->mod | locks[ j ], w, false, ButtonPressMask|ButtonReleaseMask,
+          GrabModeAsync, GrabModeSync, None, None);
   }
 }
 
 void NeuroSystemUngrabButtons(Window w, const NeuroButton *const *button_list) {
   if (!button_list)
     return;
+  const unsigned int locks[] = { 0U, LockMask, numlock_mask_, numlock_mask_|LockMask };
   for (NeuroIndex i = 0U; button_list[ i ]; ++i) {
     const NeuroButton *b = button_list[ i ];
-    if (b->ungrab_on_focus)
-      XUngrabButton(display_, b->button, b->mod, w);
+    if (!b->ungrab_on_focus)
+      continue;
+    for (NeuroIndex j = 0U; j < sizeof(locks)/sizeof(unsigned int); ++j)
+      XUngrabButton(display_, b->button, b->mod | locks[ j ], w);
   }
 }
 
@@ -18,9 +18,10 @@
 
 // Defines
 #define NEURO_SYSTEM_CLIENT_MASK (FocusChangeMask|PropertyChangeMask|StructureNotifyMask|EnterWindowMask)
-#define NEURO_SYSTEM_CLIENT_MASK_NO_ENTER (FocusChangeMask|PropertyChangeMask|StructureNotifyMask)
 #define NEURO_SYSTEM_ROOT_MASK (SubstructureRedirectMask|SubstructureNotifyMask|ButtonPressMask|StructureNotifyMask|\
                                 NEURO_SYSTEM_CLIENT_MASK)
+#define NEURO_SYSTEM_MODIFIER_MASK (ShiftMask|ControlMask|Mod1Mask|Mod2Mask|Mod3Mask|Mod4Mask|Mod5Mask)
+#define NEURO_SYSTEM_BINDING_MATCH_MAX 16
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -40,6 +41,7 @@ typedef enum NeuroSystemCursor NeuroSystemCursor;
 enum NeuroSystemWmatom {
   NEURO_SYSTEM_WMATOM_PROTOCOLS = 0,
   NEURO_SYSTEM_WMATOM_DELETEWINDOW,
+  NEURO_SYSTEM_WMATOM_STATE,
   NEURO_SYSTEM_WMATOM_END
 };
 typedef enum NeuroSystemWmatom NeuroSystemWmatom;
@@ -53,6 +55,8 @@ enum NeuroSystemNetatom {
   NEURO_SYSTEM_NETATOM_ACTIVE,
   NEURO_SYSTEM_NETATOM_CLOSEWINDOW,
   NEURO_SYSTEM_NETATOM_STRUT,
+  NEURO_SYSTEM_NETATOM_SYNC_REQUEST,
+  NEURO_SYSTEM_NETATOM_SYNC_REQUEST_COUNTER,
   NEURO_SYSTEM_NETATOM_END
 };
 typedef enum NeuroSystemNetatom NeuroSystemNetatom;
@@ -86,6 +90,11 @@ void NeuroSystemGetPointerWindowLocation(NeuroPoint *p, Window *w);
 Cursor NeuroSystemGetCursor(NeuroSystemCursor c);
 Atom NeuroSystemGetWmAtom(NeuroSystemWmatom a);
 Atom NeuroSystemGetNetAtom(NeuroSystemNetatom a);
+void NeuroSystemSetWmState(Window w, long state);
+void NeuroSystemIgnoreCrossing(void);
+bool NeuroSystemIsIgnoredCrossing(unsigned long serial);
+bool NeuroSystemHasSync(void);
+int NeuroSystemGetSyncEventBase(void);
 NeuroColor NeuroSystemGetColor(NeuroSystemColor c);
 NeuroColor NeuroSystemGetColorFromHex(const char *color);
 void NeuroSystemChangeWmName(const char *name);
@@ -100,6 +109,12 @@ int NeuroSystemSpawnPipe(const char *const *cmd, pid_t *p);
 void NeuroSystemError(const char *function_name, const char *msg);
 
 // Binding functions
+bool NeuroSystemUpdateBindings(void);
+bool NeuroSystemUpdateKeyBindings(const NeuroKey *const *key_list);
+bool NeuroSystemUpdateButtonBindings(const NeuroButton *const *button_list);
+unsigned int NeuroSystemCleanMask(unsigned int mod);
+NeuroIndex NeuroSystemFindKeyBindings(const NeuroKey **dst, unsigned int keycode, unsigned int mod);
+NeuroIndex NeuroSystemFindButtonBindings(const NeuroButton **dst, unsigned int button, unsigned int mod);
 void NeuroSystemGrabKeys(Window w, const NeuroKey *const *key_list);
 void NeuroSystemUngrabKeys(Window w, const NeuroKey *const *key_list);
 void NeuroSystemGrabButtons(Window w, const NeuroButton *const *button_list);
@@ -13,6 +13,7 @@
 
 // Includes
 #include "type.h"
+#include "core.h"
 #include "geometry.h"
 #include "rule.h"
 #include "system.h"
@@ -24,9 +25,14 @@
 
 // Creation and Destruction
 NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
-  NeuroClient *const c = (NeuroClient *)malloc(sizeof(NeuroClient));
+  NeuroClient *const c = NeuroCoreAllocClient();
   if (!c)
     return NULL;
+  const char *const empty = NeuroCoreInternString("");
+  if (!empty) {
+    NeuroCoreFreeClient(c);
+    return NULL;
+  }
 
   // Set region
   c->float_region.p.x = wa ? wa->x : 0;
@@ -40,9 +46,15 @@ NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
   // Set the properties
   c->ws = 0;
   c->is_nsp = false;
-  c->class[ 0 ] = '\0';
-  c->name[ 0 ] = '\0';
-  c->title[ 0 ] = '\0';
+  c->info->class = empty;
+  c->info->name = empty;
+  c->info->title[ 0 ] = '\0';
+  c->info->pending_batch = 0U;
+  c->info->has_shadow = false;
+  c->info->stack_stamp = SIZE_MAX;  // Mapped windows start on top
+  c->info->shadow.is_hidden = false;
+  c->info->shadow.parent = NeuroSystemGetRoot();
+  c->info->unmap_ignores = 0U;
   c->is_fullscreen = false;
   c->free_setter_fn = NeuroRuleFreeSetterNull;
   c->fixed_pos = NEURO_FIXED_POSITION_NULL;
@@ -55,7 +67,7 @@ NeuroClient *NeuroTypeNewClient(Window w, const XWindowAttributes *wa) {
 void NeuroTypeDeleteClient(NeuroClient *c) {
   if (!c)
     return;
-  free(c);
+  NeuroCoreFreeClient(c);
   c = NULL;
 }
 
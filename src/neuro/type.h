@@ -25,11 +25,18 @@
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
 #include <X11/Xproto.h>
+#include <X11/extensions/sync.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/sysinfo.h>
 #include <sys/prctl.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
 #include <asm-generic/errno.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
@@ -126,6 +133,33 @@ enum NeuroFixedPosition {
 };
 typedef enum NeuroFixedPosition NeuroFixedPosition;
 
+// DzenChange (logger inputs changed by the events)
+enum NeuroDzenChange {
+  NEURO_DZEN_CHANGE_NULL = 0,
+  NEURO_DZEN_CHANGE_WORKSPACE = 1 << 0,
+  NEURO_DZEN_CHANGE_LAYOUT = 1 << 1,
+  NEURO_DZEN_CHANGE_TITLE = 1 << 2,
+  NEURO_DZEN_CHANGE_URGENCY = 1 << 3,
+  NEURO_DZEN_CHANGE_STACK = 1 << 4,
+  NEURO_DZEN_CHANGE_ALL = (1 << 5) - 1
+};
+typedef enum NeuroDzenChange NeuroDzenChange;
+
+// LoopMode
+enum NeuroLoopMode {
+  NEURO_LOOP_MODE_THREADS = 0,  // Blocking X loop plus the panel and cpu threads
+  NEURO_LOOP_MODE_EPOLL = 1     // Single epoll loop multiplexing X, timers, signals and panel pipes
+};
+typedef enum NeuroLoopMode NeuroLoopMode;
+
+// HideMode
+enum NeuroHideMode {
+  NEURO_HIDE_MODE_MOVE = 0,     // Clients of hidden workspaces stay mapped in the hidden region
+  NEURO_HIDE_MODE_UNMAP = 1,    // Clients of hidden workspaces are also unmapped and set Iconic, so they stop rendering
+  NEURO_HIDE_MODE_REPARENT = 2  // Clients live in a container window per workspace, only the container is unmapped
+};
+typedef enum NeuroHideMode NeuroHideMode;
+
 
 // INDEX TYPES ---------------------------------------------------------------------------------------------------------
 
@@ -150,28 +184,66 @@ struct NeuroRectangle {
 };
 typedef struct NeuroRectangle NeuroRectangle;
 
+// NeuroTransform (layout mods compiled into x' = x_scale*x + x_width_scale*w + x_region_scale*(2*rx + rw), same for y)
+struct NeuroTransform {
+  bool transpose;  // Swap the x and y axes before scaling
+  int x_scale;
+  int x_width_scale;
+  int x_region_scale;
+  int y_scale;
+  int y_height_scale;
+  int y_region_scale;
+};
+typedef struct NeuroTransform NeuroTransform;
+
 // NeuroFreeSetterFn
 typedef void (*NeuroFreeSetterFn)(NeuroRectangle *a, const NeuroRectangle *r);
 
 
 // CLIENT TYPES --------------------------------------------------------------------------------------------------------
 
-// NeuroClient
+// NeuroColor
+typedef unsigned long NeuroColor;
+
+// NeuroClientState (geometry and border of a client window)
+struct NeuroClientState {
+  NeuroRectangle region;
+  int border_width;
+  NeuroColor border_color;
+  bool is_hidden;  // Unmapped and Iconic, kept valid in the shadow even if has_shadow is false
+  Window parent;   // Root or workspace container, kept valid in the shadow even if has_shadow is false
+};
+typedef struct NeuroClientState NeuroClientState;
+
+// NeuroClientInfo (cold data, read by rules, panels and the update flush)
+struct NeuroClientInfo {
+  const char *class;  // Interned, see NeuroCoreInternString
+  const char *name;   // Interned, see NeuroCoreInternString
+  char title[ NEURO_NAME_SIZE_MAX ];
+  NeuroClientState shadow;   // Last state sent to the server
+  NeuroClientState pending;  // State sent by the next flush, see NeuroClientFlushUpdates
+  NeuroIndex pending_batch;  // Batch the window was queued in
+  bool has_shadow;           // False until a state is sent, or if the server state was changed elsewhere
+  NeuroIndex stack_stamp;    // Stacking order kept by the WM, higher stamps are above lower ones
+  NeuroIndex unmap_ignores;  // UnmapNotify events still to come from windows unmapped by the WM
+};
+typedef struct NeuroClientInfo NeuroClientInfo;
+
+// NeuroClient (hot data read by layouts, focus and setters, keep it within 64 bytes)
 struct NeuroClient {
   NeuroRectangle float_region;
   Window win;
   NeuroIndex ws;
-  bool is_nsp;
-  char class[ NEURO_NAME_SIZE_MAX ];
-  char name[ NEURO_NAME_SIZE_MAX ];
-  char title[ NEURO_NAME_SIZE_MAX ];
-  bool is_fullscreen;
   NeuroFreeSetterFn free_setter_fn;
-  NeuroFixedPosition fixed_pos;
+  NeuroClientInfo *info;
   float fixed_size;
+  NeuroFixedPosition fixed_pos;
+  bool is_nsp;
+  bool is_fullscreen;
   bool is_urgent;
 };
 typedef struct NeuroClient NeuroClient;
+_Static_assert(sizeof(NeuroClient) <= 64, "NeuroClient must fit in a single cache line");
 
 // NeuroClientPtrPtr
 typedef NeuroClient **NeuroClientPtrPtr;
@@ -183,6 +255,18 @@ typedef bool (*NeuroClientTesterFn)(NeuroClientPtrPtr c, const void *p);
 typedef NeuroClientPtrPtr (*NeuroClientSelectorFn)(NeuroClientPtrPtr c);
 
 
+// CORE TYPES ----------------------------------------------------------------------------------------------------------
+
+// NeuroPoolStats
+struct NeuroPoolStats {
+  NeuroIndex capacity;     // Number of slots the pool owns
+  NeuroIndex used;         // Number of slots currently handed out
+  NeuroIndex allocs;       // Number of slots handed out since the pool was created
+  NeuroIndex heap_allocs;  // Number of chunks requested to the heap since the pool was created
+};
+typedef struct NeuroPoolStats NeuroPoolStats;
+
+
 // DZEN TYPES ----------------------------------------------------------------------------------------------------------
 
 // NeuroDzenBox
@@ -228,6 +312,7 @@ struct NeuroDzenPanel {
   const NeuroDzenLoggerFn *const loggers;
   const char *const sep;
   const uint32_t refresh_rate;
+  const NeuroDzenChange changes;  // Inputs the loggers depend on, NULL derives them from the loggers
 };
 typedef struct NeuroDzenPanel NeuroDzenPanel;
 
@@ -319,15 +404,21 @@ typedef struct NeuroActionChain NeuroActionChain;
 
 // LAYOUT TYPES --------------------------------------------------------------------------------------------------------
 
-// NeuroColor
-typedef unsigned long NeuroColor;
-
 // NeuroColorSetterFn
 typedef NeuroColor (*NeuroColorSetterFn)(NeuroClientPtrPtr c);
 
 // NeuroBorderSetterFn
 typedef int (*NeuroBorderSetterFn)(NeuroClientPtrPtr c);
 
+// NeuroRenderContext (stack data shared by all the clients of an update pass)
+typedef struct NeuroRenderContext NeuroRenderContext;
+
+// NeuroColorContextSetterFn
+typedef NeuroColor (*NeuroColorContextSetterFn)(NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+
+// NeuroBorderContextSetterFn
+typedef int (*NeuroBorderContextSetterFn)(NeuroClientPtrPtr c, const NeuroRenderContext *rc);
+
 // NeuroArrange
 struct NeuroArrange {
   NeuroIndex size;                        // Number of tiled clients
@@ -341,6 +432,22 @@ typedef struct NeuroArrange NeuroArrange;
 // NeuroArrangerFn
 typedef NeuroArrange *(*NeuroArrangerFn)(NeuroArrange *);
 
+// NeuroDenseArrange (like NeuroArrange, but the client regions are stored in contiguous arrays)
+struct NeuroDenseArrange {
+  NeuroIndex size;                        // Number of tiled clients
+  NeuroRectangle region;                  // Tiled layout region
+  int *xs;                                // X position of each client
+  int *ys;                                // Y position of each client
+  int *ws;                                // Width of each client
+  int *hs;                                // Height of each client
+  NeuroRectangle **client_float_regions;  // Float region of each client
+  NeuroArg *parameters;                   // Parameters of the arrange
+};
+typedef struct NeuroDenseArrange NeuroDenseArrange;
+
+// NeuroDenseArrangerFn
+typedef NeuroDenseArrange *(*NeuroDenseArrangerFn)(NeuroDenseArrange *);
+
 // NeuroLayout
 struct NeuroLayout {
   NeuroArrangerFn arranger_fn;
@@ -351,9 +458,33 @@ struct NeuroLayout {
   NeuroLayoutMod mod;
   bool follow_mouse;
   NeuroArg parameters[ NEURO_ARRANGE_ARGS_MAX ];
+  NeuroDenseArrangerFn dense_arranger_fn;  // Used instead of arranger_fn if set
+  NeuroTransform transform;  // Compiled mod, see NeuroGeometryTransformSetLayoutMod
+  NeuroColorContextSetterFn border_color_context_setter_fn;  // Used instead of border_color_setter_fn if set
+  NeuroBorderContextSetterFn border_width_context_setter_fn;  // Used instead of border_width_setter_fn if set
+  NeuroBorderContextSetterFn border_gap_context_setter_fn;    // Used instead of border_gap_setter_fn if set
 };
 typedef struct NeuroLayout NeuroLayout;
 
+// NeuroRenderContext
+struct NeuroRenderContext {
+  NeuroIndex ws;                                 // Stack being updated
+  const NeuroLayout *layout;                     // Current layout of the stack
+  const NeuroRectangle *stack_region;            // Region of the stack
+  const NeuroRectangle *screen_region;           // Region of the screen
+  const int *gaps;                               // Gaps of the stack
+  int border_width;                              // Configured border width
+  int border_gap;                                // Configured border gap
+  bool is_float_layout;                          // The layout arranges the float regions
+  bool has_fixed_client;                         // The stack has a fixed client
+  NeuroColorContextSetterFn color_setter_fn;     // Resolved border color setter
+  NeuroBorderContextSetterFn width_setter_fn;    // Resolved border width setter
+  NeuroBorderContextSetterFn gap_setter_fn;      // Resolved border gap setter
+  bool is_hidden;                                // The clients of the stack are unmapped, see NeuroHideMode
+  Window parent;                                 // Container of the stack, or the root if there are no containers
+  NeuroPoint parent_origin;                      // Client regions are sent relative to the parent
+};
+
 
 // CONFIG TYPES --------------------------------------------------------------------------------------------------------
 
@@ -368,6 +499,10 @@ struct NeuroLayoutConf {
   const NeuroLayoutMod mod;
   const bool follow_mouse;
   const NeuroArg parameters[ NEURO_ARRANGE_ARGS_MAX ];
+  const NeuroDenseArrangerFn dense_arranger_fn;  // Optional, used instead of arranger_fn if set
+  const NeuroColorContextSetterFn border_color_context_setter_fn;  // Optional, see NeuroLayout
+  const NeuroBorderContextSetterFn border_width_context_setter_fn;  // Optional, see NeuroLayout
+  const NeuroBorderContextSetterFn border_gap_context_setter_fn;    // Optional, see NeuroLayout
 };
 typedef struct NeuroLayoutConf NeuroLayoutConf;
 
@@ -428,6 +563,11 @@ struct NeuroConfiguration {
   const NeuroRule *const *const rule_list;
   const NeuroKey *const *const key_list;
   const NeuroButton *const *const button_list;
+  const int max_batch_latency;  // Milliseconds spent handling queued events before relayout, 0 disables batching
+  const NeuroLoopMode loop_mode;
+  const int motion_rate;        // Updates per second of a client dragged with the mouse, 0 updates on every motion
+  const NeuroHideMode hide_mode;
+  const int max_grab_time;      // Milliseconds a transaction can hold the server grabbed, 0 never grabs it
 };
 typedef struct NeuroConfiguration NeuroConfiguration;
 
@@ -18,6 +18,13 @@
 #include "core.h"
 #include "event.h"
 #include "dzen.h"
+#include "rule.h"
+#include "client.h"
+#include "workspace.h"
+
+// Defines
+#define EPOLL_EVENTS_MAX 16
+#define TICK_INTERVAL 1000  // Milliseconds between two panel and cpu refreshes in the epoll loop
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -26,6 +33,15 @@
 
 static bool stop_main_while_ = false;
 
+// EpollSource (panel pipes go after EPOLL_SOURCE_PANEL)
+enum EpollSource {
+  EPOLL_SOURCE_X = 0,
+  EPOLL_SOURCE_TIMER,
+  EPOLL_SOURCE_SIGNAL,
+  EPOLL_SOURCE_PANEL
+};
+typedef enum EpollSource EpollSource;
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
@@ -37,7 +53,10 @@ static bool recompile_wm(pid_t *pid) {
 
 static void stop_wm(void) {
   NeuroActionRunActionChain(&NeuroConfigGet()->stop_action_chain);
+  NeuroWorkspaceStop();
   NeuroDzenStop();
+  NeuroClientStop();
+  NeuroRuleStop();
   NeuroCoreStop();
   NeuroMonitorStop();
   NeuroSystemStop();
@@ -54,17 +73,168 @@ static void wm_signal_handler(int signo) {
   }
 }
 
+static uint64_t get_time_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000U + (uint64_t)ts.tv_nsec/1000000U;
+}
+
+static void handle_event(XEvent *e) {
+  const NeuroEventHandlerFn eh = NeuroEventGetHandler(e->type);
+  if (eh)
+    eh(e);
+}
+
+// Handles every queued event (up to the max batch latency) before the relayout and panel refresh
+static void handle_event_batch(XEvent *e, int max_latency) {
+  NeuroEventBeginBatch();
+  handle_event(e);
+  const uint64_t start = max_latency > 0 ? get_time_ms() : 0U;
+  while (max_latency > 0 && !stop_main_while_ && XPending(NeuroSystemGetDisplay()) &&
+      get_time_ms() - start < (uint64_t)max_latency) {
+    XNextEvent(NeuroSystemGetDisplay(), e);
+    handle_event(e);
+  }
+  NeuroEventEndBatch();
+}
+
+static bool add_epoll_fd(int efd, int fd, uint32_t events, uint64_t source) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.u64 = source;
+  return epoll_ctl(efd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+// Note: The timer is disarmed if is_armed is false
+static void arm_timer(int tfd, bool is_armed, uint64_t deadline_ms) {
+  struct itimerspec its;
+  memset(&its, 0, sizeof(its));
+  if (is_armed) {
+    its.it_value.tv_sec = (time_t)(deadline_ms / 1000U);
+    its.it_value.tv_nsec = (long)(deadline_ms % 1000U) * 1000000L;
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0L)
+      its.it_value.tv_nsec = 1L;
+  }
+  timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void handle_signals(int sfd) {
+  struct signalfd_siginfo si;
+  while (read(sfd, &si, sizeof(si)) == (ssize_t)sizeof(si)) {
+    if (si.ssi_signo == SIGCHLD)
+      while (waitpid(-1, NULL, WNOHANG) > 0)
+        continue;
+    else if (si.ssi_signo == SIGUSR1)
+      wm_signal_handler(SIGUSR1);
+  }
+}
+
+// Multiplexes the X connection, the tick and panel frame timer, SIGCHLD, SIGUSR1 and the panel pipes
+static void run_epoll_loop(void) {
+  Display *const display = NeuroSystemGetDisplay();
+
+  // Block the signals so that they are only read through the signalfd
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  sigaddset(&mask, SIGUSR1);
+  if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
+    NeuroSystemError(__func__, "Could not block the signals");
+
+  // Create the epoll set
+  const int sfd = signalfd(-1, &mask, SFD_NONBLOCK|SFD_CLOEXEC);
+  const int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK|TFD_CLOEXEC);
+  const int efd = epoll_create1(EPOLL_CLOEXEC);
+  if (sfd == -1 || tfd == -1 || efd == -1)
+    NeuroSystemError(__func__, "Could not create the event loop descriptors");
+  if (!add_epoll_fd(efd, ConnectionNumber(display), EPOLLIN, EPOLL_SOURCE_X) ||
+      !add_epoll_fd(efd, tfd, EPOLLIN, EPOLL_SOURCE_TIMER) || !add_epoll_fd(efd, sfd, EPOLLIN, EPOLL_SOURCE_SIGNAL))
+    NeuroSystemError(__func__, "Could not add the event loop descriptors");
+  for (NeuroIndex i = 0U; i < NeuroDzenGetNumPanels(); ++i)
+    if (!add_epoll_fd(efd, NeuroDzenGetPanelFd(i), EPOLLOUT|EPOLLET, EPOLL_SOURCE_PANEL + i))
+      NeuroSystemError(__func__, "Could not add the panel pipes");
+
+  const int max_latency = NeuroConfigGet()->max_batch_latency;
+  uint64_t next_tick = get_time_ms() + TICK_INTERVAL, armed_deadline = 0U;
+  bool is_armed = false;
+  XEvent ev;
+  while (!stop_main_while_) {
+    // Xlib may have read the events already, so do not rely on the connection being readable
+    if (XPending(display)) {
+      XNextEvent(display, &ev);
+      handle_event_batch(&ev, max_latency);
+      if (stop_main_while_)
+        break;
+    }
+
+    // Arm the timer for the next tick or deferred panel frame, it stays disarmed when there is nothing to refresh
+    const uint64_t now = get_time_ms();
+    const int64_t frame = NeuroDzenRunFrame();
+    bool is_deadline = NeuroDzenIsTicking();
+    uint64_t deadline = next_tick;
+    if (frame >= 0 && (!is_deadline || now + (uint64_t)frame < deadline)) {
+      deadline = now + (uint64_t)frame;
+      is_deadline = true;
+    }
+    if (is_deadline != is_armed || deadline != armed_deadline) {
+      arm_timer(tfd, is_deadline, deadline);
+      is_armed = is_deadline;
+      armed_deadline = deadline;
+    }
+
+    // Wait, without blocking if Xlib still has queued events
+    XFlush(display);
+    struct epoll_event events[ EPOLL_EVENTS_MAX ];
+    const int n = epoll_wait(efd, events, EPOLL_EVENTS_MAX, XEventsQueued(display, QueuedAlready) ? 0 : -1);
+    if (n == -1 && errno != EINTR)
+      NeuroSystemError(__func__, "Could not wait for events");
+    for (int i = 0; i < n; ++i) {
+      const uint64_t source = events[ i ].data.u64;
+      if (source == EPOLL_SOURCE_TIMER) {
+        uint64_t expirations = 0U;
+        if (read(tfd, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+          perror("run_epoll_loop - Could not read the timer");
+        is_armed = false;
+        const uint64_t time = get_time_ms();
+        if (time >= next_tick) {
+          NeuroDzenTick();
+          next_tick += TICK_INTERVAL;
+          if (next_tick <= time)  // Skip the ticks missed
+            next_tick = time + TICK_INTERVAL;
+        }
+      } else if (source == EPOLL_SOURCE_SIGNAL) {
+        handle_signals(sfd);
+      } else if (source >= EPOLL_SOURCE_PANEL) {
+        NeuroDzenFlushPanel((NeuroIndex)(source - EPOLL_SOURCE_PANEL));
+      }
+    }
+  }
+
+  // Release the event loop
+  close(efd);
+  close(tfd);
+  close(sfd);
+  sigprocmask(SIG_UNBLOCK, &mask, NULL);
+}
+
 static void init_wm(const NeuroConfiguration *c) {
   // Set the configuration
   NeuroConfigSet(c);
 
-  // Init System, NeuroMonitor, Core and Panels
+  // Init System, NeuroMonitor, Core, Rules, Clients and Panels
   if (!NeuroSystemInit())
     NeuroSystemError(__func__, "Could not init System module");
   if (!NeuroMonitorInit())
     NeuroSystemError(__func__, "Could not init Monitor module");
   if (!NeuroCoreInit())
     NeuroSystemError(__func__, "Could not init Core module");
+  if (!NeuroRuleInit())
+    NeuroSystemError(__func__, "Could not init Rule module");
+  if (!NeuroWorkspaceInit())
+    NeuroSystemError(__func__, "Could not init Workspace module");
+  if (!NeuroClientInit())
+    NeuroSystemError(__func__, "Could not init Client module");
   if (!NeuroDzenInit())
     NeuroSystemError(__func__, "Could not init Dzen module");
 
@@ -79,7 +249,9 @@ static void init_wm(const NeuroConfiguration *c) {
   //   NeuroSystemError("init_wm - Could not set SIGHUP handler");
 
   // Load existing windows if Xsesion was not closed
+  NeuroEventBeginBatch();
   NeuroEventLoadWindows();
+  NeuroEventEndBatch();
 }
 
 
@@ -92,11 +264,12 @@ int NeuroWmRun(const NeuroConfiguration *c) {
   init_wm(c);
 
   // Main loop
-  XEvent ev;
-  while (!stop_main_while_ && !XNextEvent(NeuroSystemGetDisplay(), &ev)) {
-    const NeuroEventHandlerFn eh = NeuroEventGetHandler(ev.type);
-    if (eh)
-      eh(&ev);
+  if (NeuroConfigGet()->loop_mode == NEURO_LOOP_MODE_EPOLL) {
+    run_epoll_loop();
+  } else {
+    XEvent ev;
+    while (!stop_main_while_ && !XNextEvent(NeuroSystemGetDisplay(), &ev))
+      handle_event_batch(&ev, NeuroConfigGet()->max_batch_latency);
   }
 
   // Stop window manager
@@ -19,6 +19,10 @@
 #include "layout.h"
 #include "client.h"
 #include "rule.h"
+#include "geometry.h"
+
+// Defines
+#define RESTACK_MIN_CAPACITY 32
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -28,6 +32,46 @@
 // ClientFn
 typedef void (*WorkspaceClientFn)(NeuroClientPtrPtr c, const void *data);
 
+// Container (window the clients of a stack are reparented into, see NEURO_HIDE_MODE_REPARENT)
+typedef struct Container Container;
+struct Container {
+  Window win;
+  NeuroRectangle region;  // Last region sent to the server
+  bool is_mapped;
+  bool is_map_pending;    // Mapped once the outermost transaction flushes its clients
+};
+
+// RestackBuffers (one block carved in arrays of capacity elements, kept between focuses so they do not allocate)
+typedef struct RestackBuffers RestackBuffers;
+struct RestackBuffers {
+  void *block;
+  NeuroIndex capacity;
+  NeuroClientPtrPtr *stacked;      // Clients in the old stacking order, from top to bottom
+  NeuroClientPtrPtr *restacked;    // Clients in the new stacking order, it also holds the stamp slots of the old one
+  Window *old_wins;
+  Window *new_wins;
+  NeuroIndex *new_pos;             // Old position of every window of the new order
+  NeuroIndex *tails;               // Last window of the best increasing subsequence of every length
+  NeuroIndex *prevs;               // Previous window in the increasing subsequence of every window
+  NeuroWorkspaceRestack *changes;
+  bool *is_kept;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Stack stamp of the last restacked window, see NeuroWorkspaceFocus
+static NeuroIndex stack_stamp_ = 0U;
+
+// Buffers of NeuroWorkspaceFocus and NeuroWorkspaceGetRestack
+static RestackBuffers restack_ = { NULL, 0U, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+// Containers of every stack, NULL if the clients are not reparented
+static Container *containers_ = NULL;
+static NeuroIndex containers_size_ = 0U;
+
 
 //----------------------------------------------------------------------------------------------------------------------
 // PRIVATE FUNCTION DEFINITION
@@ -38,6 +82,207 @@ static bool is_above_tiled_client(const NeuroClientPtrPtr c) {
   return (NEURO_CLIENT_PTR(c)->free_setter_fn != NeuroRuleFreeSetterNull) || NEURO_CLIENT_PTR(c)->is_fullscreen;
 }
 
+static bool reserve_restack(NeuroIndex n) {
+  if (n <= restack_.capacity)
+    return true;
+  NeuroIndex capacity = restack_.capacity > 0U ? 2U*restack_.capacity : RESTACK_MIN_CAPACITY;
+  while (capacity < n)
+    capacity *= 2U;
+  unsigned char *const block = (unsigned char *)malloc(capacity*(2U*sizeof(NeuroClientPtrPtr) + 2U*sizeof(Window) +
+      3U*sizeof(NeuroIndex) + sizeof(NeuroWorkspaceRestack) + sizeof(bool)));
+  if (!block)
+    return false;
+  free(restack_.block);
+  restack_.block = block;
+  restack_.capacity = capacity;
+
+  // Arrays are carved by decreasing alignment
+  unsigned char *p = block;
+  restack_.stacked = (NeuroClientPtrPtr *)(void *)p;
+  p += capacity*sizeof(NeuroClientPtrPtr);
+  restack_.restacked = (NeuroClientPtrPtr *)(void *)p;
+  p += capacity*sizeof(NeuroClientPtrPtr);
+  restack_.old_wins = (Window *)(void *)p;
+  p += capacity*sizeof(Window);
+  restack_.new_wins = (Window *)(void *)p;
+  p += capacity*sizeof(Window);
+  restack_.new_pos = (NeuroIndex *)(void *)p;
+  p += capacity*sizeof(NeuroIndex);
+  restack_.tails = (NeuroIndex *)(void *)p;
+  p += capacity*sizeof(NeuroIndex);
+  restack_.prevs = (NeuroIndex *)(void *)p;
+  p += capacity*sizeof(NeuroIndex);
+  restack_.changes = (NeuroWorkspaceRestack *)(void *)p;
+  p += capacity*sizeof(NeuroWorkspaceRestack);
+  restack_.is_kept = (bool *)(void *)p;
+  return true;
+}
+
+static NeuroIndex get_stack_stamp(const NeuroClientPtrPtr c) {
+  assert(c);
+  return NEURO_CLIENT_PTR(c)->info->stack_stamp;
+}
+
+static int compare_stack_stamps(const void *a, const void *b) {
+  const NeuroIndex sa = get_stack_stamp(*(const NeuroClientPtrPtr *)a);
+  const NeuroIndex sb = get_stack_stamp(*(const NeuroClientPtrPtr *)b);
+  return sa < sb ? 1 : (sa > sb ? -1 : 0);
+}
+
+// Gets the clients of the stack by the stacking model, from top to bottom
+// Note: the last focus gave the clients of the stack consecutive stamps, so they are placed by their stamp without
+// sorting, only the clients moved from other stacks are sorted below them and new clients go on top in stack order
+static void get_stacked_clients(NeuroClientPtrPtr *dst, NeuroClientPtrPtr *slots, NeuroIndex ws, NeuroIndex n) {
+  assert(dst);
+  assert(slots);
+  NeuroIndex top = 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    const NeuroIndex stamp = get_stack_stamp(NeuroCoreStackGetClient(ws, i));
+    if (stamp != SIZE_MAX && stamp > top)
+      top = stamp;
+  }
+
+  // New clients are placed first and older clients last, in any order
+  memset(slots, 0, n*sizeof(NeuroClientPtrPtr));
+  NeuroIndex size = 0U, older = 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    NeuroClientPtrPtr c = NeuroCoreStackGetClient(ws, i);
+    const NeuroIndex stamp = get_stack_stamp(c);
+    if (stamp == SIZE_MAX)
+      dst[ size++ ] = c;
+    else if (top - stamp < n)
+      slots[ top - stamp ] = c;
+    else
+      dst[ n - ++older ] = c;
+  }
+  for (NeuroIndex i = 0U; i < n; ++i)
+    if (slots[ i ])
+      dst[ size++ ] = slots[ i ];
+  qsort(dst + size, older, sizeof(NeuroClientPtrPtr), compare_stack_stamps);
+}
+
+// Gives the clients consecutive stamps in their new order, from top to bottom
+static void stamp_clients(NeuroClientPtrPtr *restacked, Window *new_wins, NeuroIndex n) {
+  assert(restacked);
+  assert(new_wins);
+  stack_stamp_ += n;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    new_wins[ i ] = NEURO_CLIENT_PTR(restacked[ i ])->win;
+    NEURO_CLIENT_PTR(restacked[ i ])->info->stack_stamp = stack_stamp_ - i;
+  }
+}
+
+static void set_restack(NeuroWorkspaceRestack *r, Window win, Window sibling, int stack_mode) {
+  assert(r);
+  r->win = win;
+  r->sibling = sibling;
+  r->stack_mode = stack_mode;
+}
+
+// Sends the whole order if the server order is unknown, otherwise only the sibling changes
+static void restack_windows(NeuroIndex ws, const Window *old_wins, Window *new_wins, NeuroIndex n) {
+  assert(old_wins);
+  assert(new_wins);
+  assert(n <= restack_.capacity);
+  Display *const dpy = NeuroSystemGetDisplay();
+  if (!NeuroCoreStackIsStackingKnown(ws)) {
+    XRestackWindows(dpy, new_wins, n);
+    NeuroCoreStackSetStackingKnown(ws, true);
+    NeuroSystemIgnoreCrossing();
+    return;
+  }
+
+  NeuroWorkspaceRestack *const changes = restack_.changes;
+  const NeuroIndex size = NeuroWorkspaceGetRestack(changes, old_wins, restack_.new_pos, n);
+  for (NeuroIndex i = 0U; i < size; ++i) {
+    XWindowChanges wc;
+    wc.sibling = changes[ i ].sibling;
+    wc.stack_mode = changes[ i ].stack_mode;
+    XConfigureWindow(dpy, changes[ i ].win, CWSibling|CWStackMode, &wc);
+  }
+  if (size > 0U)
+    NeuroSystemIgnoreCrossing();
+}
+
+static void get_container_region(NeuroRectangle *dst, NeuroIndex ws) {
+  assert(dst);
+  NeuroGeometryRectangleGetIncreased(dst, NeuroCoreStackGetRegion(ws), NeuroCoreStackGetGaps(ws));
+}
+
+static void map_container(Container *ct) {
+  assert(ct);
+  XMapWindow(NeuroSystemGetDisplay(), ct->win);
+  ct->is_mapped = true;
+  ct->is_map_pending = false;
+  NeuroSystemIgnoreCrossing();
+}
+
+// Note: the queued clients are flushed before the container is mapped, so they are shown with their new geometry
+// Note: inside a transaction the flush is deferred, so the container is mapped when the transaction ends
+static void update_container(NeuroIndex ws) {
+  if (!containers_)
+    return;
+  Container *const ct = containers_ + ws;
+  Display *const dpy = NeuroSystemGetDisplay();
+  if (!NeuroCoreStackGetMonitor(ws)) {
+    ct->is_map_pending = false;
+    if (ct->is_mapped) {
+      XUnmapWindow(dpy, ct->win);
+      ct->is_mapped = false;
+      NeuroSystemIgnoreCrossing();
+    }
+    return;
+  }
+
+  NeuroRectangle r;
+  get_container_region(&r, ws);
+  if (memcmp(&r, &ct->region, sizeof(NeuroRectangle))) {
+    XMoveResizeWindow(dpy, ct->win, r.p.x, r.p.y, r.w, r.h);
+    memmove(&ct->region, &r, sizeof(NeuroRectangle));
+  }
+  if (ct->is_mapped)
+    return;
+  if (NeuroClientIsInTransaction()) {
+    ct->is_map_pending = true;
+    return;
+  }
+  NeuroClientFlushUpdates();
+  map_container(ct);
+}
+
+// Stacks hidden in their container keep their region, so showing them again on a monitor of the same size is free
+static void set_stack_monitor(NeuroIndex ws, const NeuroMonitor *m) {
+  if (!m && containers_)
+    NeuroCoreStackDetachMonitor(ws);
+  else
+    NeuroCoreStackSetMonitor(ws, m);
+}
+
+// Maps the clients hidden by the updates back, so that they are not lost when the WM exits
+static void map_clients(NeuroIndex ws) {
+  for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c)) {
+    NeuroClientInfo *const info = NEURO_CLIENT_PTR(c)->info;
+    if (!info->shadow.is_hidden)
+      continue;
+    NeuroSystemSetWmState(NEURO_CLIENT_PTR(c)->win, NormalState);
+    XMapWindow(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win);
+    info->shadow.is_hidden = false;
+  }
+}
+
+// Reparents the client back to the root, offset is the position its container has on the screen
+static void release_client(NeuroClient *cli, const NeuroPoint *offset) {
+  assert(cli);
+  assert(offset);
+  NeuroClientState *const s = &cli->info->shadow;
+  if (s->parent == NeuroSystemGetRoot())
+    return;
+  XReparentWindow(NeuroSystemGetDisplay(), cli->win, NeuroSystemGetRoot(), s->region.p.x + offset->x,
+      s->region.p.y + offset->y);
+  XRemoveFromSaveSet(NeuroSystemGetDisplay(), cli->win);
+  s->parent = NeuroSystemGetRoot();
+}
+
 static void focus_client(NeuroClientPtrPtr c) {
   assert(c);
   NeuroClientUnsetUrgent(c, NULL);
@@ -74,14 +319,9 @@ static void send_client(NeuroClientPtrPtr c, const void *data) {
   if (old_ws == new_ws)
     return;
 
-  // Remove the client from its stack
-  NeuroClient *const cli = NeuroCoreRemoveClient(c);
-
-  // Add the client to the new stack
-  cli->ws = new_ws;
-  const NeuroClientPtrPtr c2 = NeuroCoreAddClientStart(cli);
-  if (!c2)
-    NeuroSystemError(__func__, "Could not add client");
+  // Move the client to the new stack
+  NeuroClientBeginTransaction();
+  NeuroCoreClientMove(c, new_ws);
 
   // Update old and new workspaces
   NeuroLayoutRunCurr(curr_ws);
@@ -91,6 +331,7 @@ static void send_client(NeuroClientPtrPtr c, const void *data) {
 
   // Focus the current workspace
   NeuroWorkspaceFocus(curr_ws);
+  NeuroClientEndTransaction();
 }
 
 
@@ -98,15 +339,59 @@ static void send_client(NeuroClientPtrPtr c, const void *data) {
 // PUBLIC FUNCTION DEFINITION
 //----------------------------------------------------------------------------------------------------------------------
 
+// Note: the containers are created lowered, so that the panels spawned afterwards stay above them
+bool NeuroWorkspaceInit(void) {
+  if (NeuroConfigGet()->hide_mode != NEURO_HIDE_MODE_REPARENT)
+    return true;
+  containers_size_ = NeuroCoreGetSize();
+  containers_ = (Container *)calloc(containers_size_, sizeof(Container));
+  if (!containers_)
+    return false;
+
+  Display *const dpy = NeuroSystemGetDisplay();
+  XSetWindowAttributes wa;
+  wa.override_redirect = true;
+  wa.background_pixmap = ParentRelative;
+  wa.event_mask = SubstructureRedirectMask|SubstructureNotifyMask;
+  for (NeuroIndex i = 0U; i < containers_size_; ++i) {
+    Container *const ct = containers_ + i;
+    get_container_region(&ct->region, i);
+    ct->win = XCreateWindow(dpy, NeuroSystemGetRoot(), ct->region.p.x, ct->region.p.y, ct->region.w, ct->region.h, 0,
+        CopyFromParent, InputOutput, CopyFromParent, CWOverrideRedirect|CWBackPixmap|CWEventMask, &wa);
+    XLowerWindow(dpy, ct->win);
+    ct->is_mapped = false;
+  }
+  return true;
+}
+
+// Note: the containers are not destroyed, the server reparents the clients left in them through the save-set
+void NeuroWorkspaceStop(void) {
+  for (NeuroIndex ws = 0U; ws < NeuroCoreGetSize(); ++ws) {
+    map_clients(ws);
+    if (!containers_)
+      continue;
+    const NeuroPoint *const offset = NeuroCoreStackGetMonitor(ws) ? &containers_[ ws ].region.p :
+        &NeuroSystemGetHiddenRegion()->p;
+    for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
+      release_client(NEURO_CLIENT_PTR(c), offset);
+  }
+  free(containers_);
+  containers_ = NULL;
+  containers_size_ = 0U;
+  free(restack_.block);
+  memset(&restack_, 0, sizeof(RestackBuffers));
+}
+
 void NeuroWorkspaceChange(NeuroIndex ws) {
   if (NeuroCoreStackIsCurr(ws))
     return;
 
+  NeuroClientBeginTransaction();
   const NeuroIndex curr = NeuroCoreGetCurrStack();
   const NeuroMonitor *const curr_monitor = NeuroCoreStackGetMonitor(curr);
   const NeuroMonitor *const new_monitor = NeuroCoreStackGetMonitor(ws);
-  NeuroCoreStackSetMonitor(curr, new_monitor);
-  NeuroCoreStackSetMonitor(ws, curr_monitor);
+  set_stack_monitor(curr, new_monitor);
+  set_stack_monitor(ws, curr_monitor);
 
   // Update old and new workspaces
   NeuroLayoutRunCurr(curr);
@@ -118,53 +403,169 @@ void NeuroWorkspaceChange(NeuroIndex ws) {
   NeuroWorkspaceUnfocus(curr);
   NeuroCoreSetCurrStack(ws);
   NeuroWorkspaceFocus(ws);
+  NeuroClientEndTransaction();
 }
 
+// Note: the geometry is only re-emitted if the stack generation changed since the last update
 void NeuroWorkspaceUpdate(NeuroIndex ws) {
-  for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
-    NeuroClientUpdate(c, NULL);
+  if (!NeuroCoreStackIsUpdated(ws)) {
+    NeuroRenderContext rc;
+    NeuroClientGetRenderContext(&rc, ws);
+    const NeuroIndex n = NeuroCoreStackGetSize(ws);
+    for (NeuroIndex i = 0U; i < n; ++i)
+      NeuroClientUpdateWithContext(NeuroCoreStackGetClient(ws, i), &rc);
+    NeuroCoreStackSetUpdated(ws);
+  }
+  update_container(ws);
 }
 
+// Note: the stacking order is kept by the WM, so the server is never queried for it
 void NeuroWorkspaceFocus(NeuroIndex ws) {
-  NeuroIndex n = NeuroCoreStackGetSize(ws);
+  const NeuroIndex n = NeuroCoreStackGetSize(ws);
   if (n == 0) {
     XDeleteProperty(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), NeuroSystemGetNetAtom(NEURO_SYSTEM_NETATOM_ACTIVE));
     return;
   }
 
-  Window windows[ n ], d1, d2, *wins = NULL;
+  if (!reserve_restack(n))
+    NeuroSystemError(__func__, "Could not alloc the restack buffers");
+  NeuroClientPtrPtr *const stacked = restack_.stacked, *const restacked = restack_.restacked;
+  Window *const old_wins = restack_.old_wins, *const new_wins = restack_.new_wins;
+  NeuroIndex *const new_pos = restack_.new_pos;
+  get_stacked_clients(stacked, restacked, ws, n);
   NeuroIndex atc = 0U;
-  NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws);
-  for ( ; c; c = NeuroCoreClientGetNext(c))
-    if (is_above_tiled_client(c))
+  for (NeuroIndex i = 0U; i < n; ++i)
+    if (is_above_tiled_client(stacked[ i ]))
       ++atc;
 
-  c = NeuroCoreStackGetCurrClient(ws);
-  windows[ is_above_tiled_client(c) ? 0U : atc ] = NEURO_CLIENT_PTR(c)->win;
+  NeuroRenderContext rc;
+  NeuroClientGetRenderContext(&rc, ws);
+  NeuroClientPtrPtr c = NeuroCoreStackGetCurrClient(ws);
+  const bool is_curr_above = is_above_tiled_client(c);
+  const NeuroIndex curr_slot = is_curr_above ? 0U : atc;
+  restacked[ curr_slot ] = c;
   focus_client(c);
-  NeuroClientUpdate(c, NULL);
-
-  if (n > 1) {
-    // XQueryTree gets windows by stacking order
-    unsigned int num = 0U;
-    if (!XQueryTree(NeuroSystemGetDisplay(), NeuroSystemGetRoot(), &d1, &d2, &wins, &num))
-      NeuroSystemError(__func__, "Could not get windows");
-    NeuroIndex n2 = n;
-    for (unsigned int i = 0U; i < num; ++i) {
-      c = NeuroWorkspaceClientFindWindow(ws, wins[ i ]);
-      if (!c)
-        continue;
-      if (NeuroCoreClientIsCurr(c))
-        continue;
-      windows[ is_above_tiled_client(c) ? --atc : --n2 ] = NEURO_CLIENT_PTR(c)->win;
-      unfocus_client(c);
-      NeuroClientUpdate(c, NULL);
+  NeuroClientUpdateWithContext(c, &rc);
+
+  // The current client goes on top of its layer, the others keep their order
+  NeuroIndex ai = is_curr_above ? 1U : 0U, ti = is_curr_above ? atc : atc + 1U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    c = stacked[ i ];
+    old_wins[ i ] = NEURO_CLIENT_PTR(c)->win;
+    if (NeuroCoreClientIsCurr(c)) {
+      new_pos[ curr_slot ] = i;
+      continue;
     }
-    if (wins)
-      XFree(wins);
+    const NeuroIndex slot = is_above_tiled_client(c) ? ai++ : ti++;
+    restacked[ slot ] = c;
+    new_pos[ slot ] = i;
+    unfocus_client(c);
+    NeuroClientUpdateWithContext(c, &rc);
   }
 
-  XRestackWindows(NeuroSystemGetDisplay(), windows, n);
+  stamp_clients(restacked, new_wins, n);
+  restack_windows(ws, old_wins, new_wins, n);
+}
+
+// Note: the client is moved within its layer, next to the sibling if it is a client of the same stack
+void NeuroWorkspaceRestackClient(NeuroClientPtrPtr c, Window sibling, int stack_mode) {
+  if (!c)
+    return;
+  const NeuroIndex ws = NEURO_CLIENT_PTR(c)->ws;
+  const NeuroIndex n = NeuroCoreStackGetSize(ws);
+  if (n < 2U || !reserve_restack(n))
+    return;
+  NeuroClientPtrPtr *const stacked = restack_.stacked, *const restacked = restack_.restacked;
+  Window *const old_wins = restack_.old_wins, *const new_wins = restack_.new_wins;
+  NeuroIndex *const new_pos = restack_.new_pos;
+  get_stacked_clients(stacked, restacked, ws, n);
+
+  // Target position in the order without the client, Above is also used for TopIf and Opposite
+  const bool is_below = stack_mode == Below || stack_mode == BottomIf;
+  NeuroIndex from = 0U, size = 0U, atc = 0U, to = is_below ? n - 1U : 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    old_wins[ i ] = NEURO_CLIENT_PTR(stacked[ i ])->win;
+    if (stacked[ i ] == c) {
+      from = i;
+      continue;
+    }
+    if (old_wins[ i ] == sibling)
+      to = is_below ? size + 1U : size;
+    if (is_above_tiled_client(stacked[ i ]))
+      ++atc;
+    ++size;
+  }
+  if (is_above_tiled_client(c) ? to > atc : to < atc)
+    to = atc;
+  if (to == from)
+    return;
+
+  // Insert the client at the target position
+  for (NeuroIndex i = 0U, j = 0U; i < n; ++i) {
+    if (i == to) {
+      restacked[ i ] = c;
+      new_pos[ i ] = from;
+      continue;
+    }
+    if (j == from)
+      ++j;
+    restacked[ i ] = stacked[ j ];
+    new_pos[ i ] = j++;
+  }
+  stamp_clients(restacked, new_wins, n);
+  restack_windows(ws, old_wins, new_wins, n);
+}
+
+// Gets the changes that turn the old stacking order into the new one, both from top to bottom with the same windows
+// Only the windows out of the longest subsequence already in order are moved, each one next to a placed neighbour
+// Note: new_pos holds the old position of every window of the new order, dst must have room for n changes
+NeuroIndex NeuroWorkspaceGetRestack(NeuroWorkspaceRestack *dst, const Window *old_wins, const NeuroIndex *new_pos,
+    NeuroIndex n) {
+  assert(dst);
+  assert(old_wins);
+  assert(new_pos);
+  if (n < 2U)
+    return 0U;
+
+  // Without buffers every window is placed below the previous one
+  if (!reserve_restack(n)) {
+    for (NeuroIndex i = 1U; i < n; ++i)
+      set_restack(dst + i - 1U, old_wins[ new_pos[ i ] ], old_wins[ new_pos[ i - 1U ] ], Below);
+    return n - 1U;
+  }
+
+  // Longest subsequence of the new order that is increasing in the old order, in O(n log n)
+  NeuroIndex *const tails = restack_.tails, *const prevs = restack_.prevs;
+  bool *const is_kept = restack_.is_kept;
+  NeuroIndex len = 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    NeuroIndex lo = 0U, hi = len;
+    while (lo < hi) {
+      const NeuroIndex mid = lo + (hi - lo)/2U;
+      if (new_pos[ tails[ mid ] ] < new_pos[ i ])
+        lo = mid + 1U;
+      else
+        hi = mid;
+    }
+    prevs[ i ] = lo > 0U ? tails[ lo - 1U ] : i;
+    tails[ lo ] = i;
+    if (lo == len)
+      ++len;
+    is_kept[ i ] = false;
+  }
+  for (NeuroIndex i = tails[ len - 1U ]; !is_kept[ i ]; i = prevs[ i ])
+    is_kept[ i ] = true;
+
+  // Windows above the first kept one are placed upwards, the others downwards
+  NeuroIndex first = 0U, size = 0U;
+  while (!is_kept[ first ])
+    ++first;
+  for (NeuroIndex i = first; i > 0U; --i)
+    set_restack(dst + size++, old_wins[ new_pos[ i - 1U ] ], old_wins[ new_pos[ i ] ], Above);
+  for (NeuroIndex i = first + 1U; i < n; ++i)
+    if (!is_kept[ i ])
+      set_restack(dst + size++, old_wins[ new_pos[ i ] ], old_wins[ new_pos[ i - 1U ] ], Below);
+  return size;
 }
 
 void NeuroWorkspaceUnfocus(NeuroIndex ws) {
@@ -172,6 +573,46 @@ void NeuroWorkspaceUnfocus(NeuroIndex ws) {
     unfocus_client(c);
 }
 
+// Note: the clients of unmapped workspaces are unmapped by the next update of each client
+bool NeuroWorkspaceIsUnmapped(NeuroIndex ws) {
+  return NeuroConfigGet()->hide_mode == NEURO_HIDE_MODE_UNMAP && !NeuroCoreStackGetMonitor(ws);
+}
+
+// Note: the origin is the position of the container, the clients are positioned relative to it
+Window NeuroWorkspaceGetContainer(NeuroPoint *origin, NeuroIndex ws) {
+  assert(origin);
+  if (!containers_) {
+    origin->x = 0;
+    origin->y = 0;
+    return NeuroSystemGetRoot();
+  }
+  NeuroRectangle r;
+  get_container_region(&r, ws);
+  memmove(origin, &r.p, sizeof(NeuroPoint));
+  return containers_[ ws % containers_size_ ].win;
+}
+
+// Note: it is called by NeuroClientEndTransaction right after the clients of the transaction are flushed
+void NeuroWorkspaceMapPendingContainers(void) {
+  for (NeuroIndex i = 0U; i < containers_size_; ++i)
+    if (containers_[ i ].is_map_pending)
+      map_container(containers_ + i);
+}
+
+bool NeuroWorkspaceIsContainer(Window w) {
+  for (NeuroIndex i = 0U; i < containers_size_; ++i)
+    if (containers_[ i ].win == w)
+      return true;
+  return false;
+}
+
+// Reparents a withdrawn client back to the root, as required by ICCCM 4.1.4
+void NeuroWorkspaceReleaseClient(NeuroClient *cli) {
+  if (!cli || !containers_)
+    return;
+  release_client(cli, &containers_[ cli->ws % containers_size_ ].region.p);
+}
+
 void NeuroWorkspaceTile(NeuroIndex ws) {
   for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
     NeuroClientTile(c, NULL);
@@ -183,7 +624,9 @@ void NeuroWorkspaceFree(NeuroIndex ws, const void *free_setter_fn) {
 }
 
 void NeuroWorkspaceMinimize(NeuroIndex ws) {
-  for (NeuroClientPtrPtr c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
+  // Minimizing releases the handle, so always take the head
+  NeuroClientPtrPtr c;
+  while ((c = NeuroCoreStackGetHeadClient(ws)))
     NeuroClientMinimize(c, NULL);
 }
 
@@ -202,29 +645,17 @@ void NeuroWorkspaceRestoreLastMinimized(NeuroIndex ws) {
   NeuroWorkspaceFocus(win);
 }
 
-void NeuroWorkspaceAddEnterNotifyMask(NeuroIndex ws) {
-  NeuroClientPtrPtr c;
-  for (c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
-    XSelectInput(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, NEURO_SYSTEM_CLIENT_MASK);
-}
-
-void NeuroWorkspaceRemoveEnterNotifyMask(NeuroIndex ws) {
-  NeuroClientPtrPtr c;
-  for (c = NeuroCoreStackGetHeadClient(ws); c; c = NeuroCoreClientGetNext(c))
-    XSelectInput(NeuroSystemGetDisplay(), NEURO_CLIENT_PTR(c)->win, NEURO_SYSTEM_CLIENT_MASK_NO_ENTER);
-}
-
 // Find functions
 NeuroClientPtrPtr NeuroWorkspaceClientFindWindow(NeuroIndex ws, Window w) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterWindow, (const void *)&w);
+  return NeuroCoreStackFindWindowClient(ws, w);
 }
 
 NeuroClientPtrPtr NeuroWorkspaceClientFindUrgent(NeuroIndex ws) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterUrgent, NULL);
+  return NeuroCoreStackFindAttributeClient(ws, NEURO_CORE_ATTRIBUTE_URGENT);
 }
 
 NeuroClientPtrPtr NeuroWorkspaceClientFindFixed(NeuroIndex ws) {
-  return NeuroCoreStackFindClient(ws, NeuroClientTesterFixed, NULL);
+  return NeuroCoreStackFindAttributeClient(ws, NEURO_CORE_ATTRIBUTE_FIXED);
 }
 
 // Note: This might return a lower window in the stacking order
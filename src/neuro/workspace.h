@@ -17,21 +17,42 @@
 #include "type.h"
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// VARIABLE DECLARATION
+//----------------------------------------------------------------------------------------------------------------------
+
+// NeuroWorkspaceRestack (stacking change of a window relative to a sibling)
+typedef struct NeuroWorkspaceRestack NeuroWorkspaceRestack;
+struct NeuroWorkspaceRestack {
+  Window win;
+  Window sibling;
+  int stack_mode;  // Above or Below the sibling
+};
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // FUNCTION DECLARATION
 //----------------------------------------------------------------------------------------------------------------------
 
 // NeuroWorkspace
+bool NeuroWorkspaceInit(void);
+void NeuroWorkspaceStop(void);
 void NeuroWorkspaceChange(NeuroIndex ws);
 void NeuroWorkspaceUpdate(NeuroIndex ws);
 void NeuroWorkspaceFocus(NeuroIndex ws);
 void NeuroWorkspaceUnfocus(NeuroIndex ws);
+void NeuroWorkspaceRestackClient(NeuroClientPtrPtr c, Window sibling, int stack_mode);
+bool NeuroWorkspaceIsUnmapped(NeuroIndex ws);
+Window NeuroWorkspaceGetContainer(NeuroPoint *origin, NeuroIndex ws);
+void NeuroWorkspaceMapPendingContainers(void);
+bool NeuroWorkspaceIsContainer(Window w);
+void NeuroWorkspaceReleaseClient(NeuroClient *cli);
+NeuroIndex NeuroWorkspaceGetRestack(NeuroWorkspaceRestack *dst, const Window *old_wins, const NeuroIndex *new_pos,
+    NeuroIndex n);
 void NeuroWorkspaceTile(NeuroIndex ws);
 void NeuroWorkspaceFree(NeuroIndex ws, const void *free_setter_fn);
 void NeuroWorkspaceMinimize(NeuroIndex ws);
 void NeuroWorkspaceRestoreLastMinimized(NeuroIndex ws);
-void NeuroWorkspaceAddEnterNotifyMask(NeuroIndex ws);
-void NeuroWorkspaceRemoveEnterNotifyMask(NeuroIndex ws);
 
 // Find
 NeuroClientPtrPtr NeuroWorkspaceClientFindWindow(NeuroIndex ws, Window w);
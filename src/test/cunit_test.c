@@ -15,7 +15,15 @@
 #include <string.h>
 #include <BCUnit/Basic.h>
 #include "../neuro/system.h"
+#include "../neuro/config.h"
 #include "../neuro/core.h"
+#include "../neuro/layout.h"
+#include "../neuro/geometry.h"
+#include "../neuro/client.h"
+#include "../neuro/event.h"
+#include "../neuro/fetch.h"
+#include "../neuro/workspace.h"
+#include "../neuro/rule.h"
 #include "../neuro/wm.h"
 
 
@@ -58,11 +66,766 @@ static void add_remove_client(void) {
   NeuroTypeDeleteClient(cli2);
 }
 
+static void find_window_client(void) {
+  // Create enough fake clients to make the window index grow
+  enum { NUM_CLIENTS = 200 };
+  NeuroClient *clis[ NUM_CLIENTS ];
+  for (NeuroIndex i = 0U; i < NUM_CLIENTS; ++i) {
+    clis[ i ] = NeuroTypeNewClient((Window)(i + 1U), NULL);
+    CU_ASSERT_PTR_NOT_NULL(clis[ i ]);
+    clis[ i ]->ws = i % NeuroCoreGetSize();
+    CU_ASSERT_PTR_NOT_NULL(NeuroCoreAddClientEnd(clis[ i ]));
+  }
+
+  // Every window must be found in its own stack only
+  for (NeuroIndex i = 0U; i < NUM_CLIENTS; ++i) {
+    NeuroClientPtrPtr c = NeuroCoreFindWindowClient((Window)(i + 1U));
+    CU_ASSERT_PTR_NOT_NULL(c);
+    CU_ASSERT(c && NEURO_CLIENT_PTR(c) == clis[ i ]);
+    CU_ASSERT(NeuroCoreStackFindWindowClient(clis[ i ]->ws, (Window)(i + 1U)) == c);
+    CU_ASSERT_PTR_NULL(NeuroCoreStackFindWindowClient(clis[ i ]->ws + 1U, (Window)(i + 1U)));
+  }
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient((Window)(NUM_CLIENTS + 1U)));
+
+  // Minimized clients are not in the stacks, but can still be removed by window
+  NeuroClient *const cli = NeuroCoreRemoveClient(NeuroCoreFindWindowClient(1UL));
+  CU_ASSERT(cli == clis[ 0 ]);
+  CU_ASSERT(NeuroCorePushMinimizedClient(cli) == cli);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient(1UL));
+  CU_ASSERT(NeuroCoreRemoveMinimizedClient(1UL) == cli);
+  CU_ASSERT_PTR_NULL(NeuroCoreRemoveMinimizedClient(1UL));
+  NeuroTypeDeleteClient(cli);
+
+  // Remove the rest of fake clients
+  for (NeuroIndex i = 1U; i < NUM_CLIENTS; ++i) {
+    NeuroClient *const cli2 = NeuroCoreRemoveClient(NeuroCoreFindWindowClient((Window)(i + 1U)));
+    CU_ASSERT(cli2 == clis[ i ]);
+    CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient((Window)(i + 1U)));
+    NeuroTypeDeleteClient(cli2);
+  }
+}
+
+static void move_client_pooled(void) {
+  // Warm up the pools with one client
+  NeuroClient *const cli = NeuroTypeNewClient(1UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  CU_ASSERT((uintptr_t)cli % 64U == 0U);
+  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  const NeuroIndex node_heap_allocs = NeuroCoreGetNodePoolStats()->heap_allocs;
+  const NeuroIndex client_heap_allocs = NeuroCoreGetClientPoolStats()->heap_allocs;
+
+  // Moving the client across every stack keeps the same node
+  for (NeuroIndex i = 1U; i <= NeuroCoreGetSize(); ++i) {
+    const NeuroIndex ws = i % NeuroCoreGetSize();
+    CU_ASSERT(NeuroCoreClientMove(c, ws) == c);
+    CU_ASSERT(NEURO_CLIENT_PTR(c) == cli && cli->ws == ws);
+    CU_ASSERT(NeuroCoreStackGetCurrClient(ws) == c);
+    CU_ASSERT(NeuroCoreFindWindowClient(1UL) == c);
+  }
+
+  // Minimize and restore churn is served from the free lists
+  for (NeuroIndex i = 0U; i < 100U; ++i) {
+    CU_ASSERT(NeuroCorePushMinimizedClient(NeuroCoreRemoveClient(c)) == cli);
+    CU_ASSERT(NeuroCorePopMinimizedClient(cli->ws) == cli);
+    c = NeuroCoreAddClientStart(cli);
+    CU_ASSERT_PTR_NOT_NULL(c);
+  }
+  CU_ASSERT(NeuroCoreGetNodePoolStats()->heap_allocs == node_heap_allocs);
+  CU_ASSERT(NeuroCoreGetClientPoolStats()->heap_allocs == client_heap_allocs);
+
+  // Remove the fake client
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+  CU_ASSERT(NeuroCoreGetNodePoolStats()->used == 0U);
+  CU_ASSERT(NeuroCoreGetClientPoolStats()->used == 0U);
+}
+
+static void stack_order(void) {
+  // Fill a stack past its initial capacity, every client is added before the current one
+  enum { NUM_CLIENTS = 1000 };
+  NeuroClientPtrPtr cs[ NUM_CLIENTS ];
+  for (NeuroIndex i = 0U; i < NUM_CLIENTS; ++i) {
+    NeuroClient *const cli = NeuroTypeNewClient((Window)(i + 1U), NULL);
+    CU_ASSERT_PTR_NOT_NULL(cli);
+    cs[ i ] = NeuroCoreAddClientStart(cli);
+    CU_ASSERT_PTR_NOT_NULL(cs[ i ]);
+  }
+  const NeuroIndex ws = NEURO_CLIENT_PTR(cs[ 0 ])->ws;
+  CU_ASSERT(NeuroCoreStackGetSize(ws) == NUM_CLIENTS);
+
+  // Handles stay valid and keep their order while the arrays grow
+  const Window *const wins = NeuroCoreStackGetWindows(ws);
+  for (NeuroIndex i = 0U; i < NUM_CLIENTS; ++i) {
+    const NeuroClientPtrPtr c = NeuroCoreStackGetClient(ws, i);
+    CU_ASSERT(c == cs[ NUM_CLIENTS - 1U - i ]);
+    CU_ASSERT(NeuroCoreClientIsValid(c));
+    CU_ASSERT(wins[ i ] == NEURO_CLIENT_PTR(c)->win);
+    CU_ASSERT(NeuroCoreClientGetNext(c) == NeuroCoreStackGetClient(ws, i + 1U));
+  }
+  CU_ASSERT(NeuroCoreClientIsHead(cs[ NUM_CLIENTS - 1U ]) && NeuroCoreClientIsLast(cs[ 0 ]));
+
+  // Swapping exchanges the clients but keeps the positions
+  NeuroRectangle *const r = NeuroCoreClientGetRegion(cs[ 0 ]);
+  NeuroClient *const cli0 = NEURO_CLIENT_PTR(cs[ 0 ]);
+  CU_ASSERT(NeuroCoreClientSwap(cs[ 0 ], cs[ 1 ]) == cs[ 1 ]);
+  CU_ASSERT(NEURO_CLIENT_PTR(cs[ 1 ]) == cli0 && NeuroCoreClientGetRegion(cs[ 0 ]) == r);
+  CU_ASSERT(NeuroCoreFindWindowClient(cli0->win) == cs[ 1 ]);
+  CU_ASSERT(NeuroCoreClientSwap(cs[ 0 ], cs[ 1 ]) == cs[ 1 ]);
+
+  // Removing from the middle shifts the following clients
+  const NeuroClientPtrPtr next = NeuroCoreClientGetNext(cs[ NUM_CLIENTS/2U ]);
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(cs[ NUM_CLIENTS/2U ]));
+  CU_ASSERT(NeuroCoreStackGetClient(ws, NUM_CLIENTS/2U - 1U) == next);
+  CU_ASSERT(NeuroCoreClientIsValid(next));
+  CU_ASSERT(NeuroCoreStackGetPrevClient(ws) != cs[ NUM_CLIENTS/2U ]);
+
+  // Remove the rest of fake clients
+  NeuroClientPtrPtr c;
+  while ((c = NeuroCoreStackGetHeadClient(ws)))
+    NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+  CU_ASSERT(NeuroCoreStackIsEmpty(ws));
+}
+
+static void intern_string(void) {
+  // Equal strings share the same pointer, even if they come from different buffers
+  char buf[ 16 ];
+  snprintf(buf, sizeof(buf), "%s", "xterm");
+  const char *const s1 = NeuroCoreInternString("xterm");
+  const char *const s2 = NeuroCoreInternString(buf);
+  CU_ASSERT_PTR_NOT_NULL(s1);
+  CU_ASSERT(s1 == s2);
+  CU_ASSERT(s1 != NeuroCoreInternString("XTerm"));
+  CU_ASSERT_PTR_NULL(NeuroCoreInternString(NULL));
+
+  // New clients start with the interned empty class and name
+  NeuroClient *const cli = NeuroTypeNewClient(1UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  CU_ASSERT(cli->info->class == NeuroCoreInternString("") && cli->info->name == cli->info->class);
+  CU_ASSERT(sizeof(NeuroClient) <= 64U);
+  NeuroTypeDeleteClient(cli);
+}
+
+static void client_attributes(void) {
+  // NSP clients are indexed as soon as they are added
+  NeuroClient *const cli1 = NeuroTypeNewClient(1UL, NULL);
+  NeuroClient *const cli2 = NeuroTypeNewClient(2UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli1);
+  CU_ASSERT_PTR_NOT_NULL(cli2);
+  cli2->is_nsp = true;
+  NeuroClientPtrPtr c1 = NeuroCoreAddClientStart(cli1);
+  NeuroClientPtrPtr c2 = NeuroCoreAddClientStart(cli2);
+  const NeuroIndex ws = cli1->ws;
+  CU_ASSERT(NeuroCoreStackGetAttributeNum(ws, NEURO_CORE_ATTRIBUTE_NSP) == 1U);
+  CU_ASSERT(NeuroCoreFindNspClient() == c2);
+
+  // Setters keep the counters and lists up to date
+  NeuroCoreClientSetUrgent(c1, true);
+  NeuroCoreClientSetUrgent(c1, true);
+  NeuroCoreClientSetFullscreen(c2, true);
+  CU_ASSERT(cli1->is_urgent && cli2->is_fullscreen);
+  CU_ASSERT(NeuroCoreStackGetAttributeNum(ws, NEURO_CORE_ATTRIBUTE_URGENT) == 1U);
+  CU_ASSERT(NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_URGENT) == c1);
+  CU_ASSERT(NeuroCoreStackFindAttributeClient(ws, NEURO_CORE_ATTRIBUTE_FULLSCREEN) == c2);
+
+  // Attributes follow the clients when they are swapped
+  NeuroCoreClientSwap(c1, c2);
+  CU_ASSERT(NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_URGENT) == c2);
+  CU_ASSERT(NeuroCoreFindNspClient() == c1);
+  NeuroCoreClientSetUrgent(c2, false);
+  CU_ASSERT(NeuroCoreStackGetAttributeNum(ws, NEURO_CORE_ATTRIBUTE_URGENT) == 0U);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindAttributeClient(NEURO_CORE_ATTRIBUTE_URGENT));
+
+  // Removing the clients clears the indexes
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c1));
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c2));
+  for (NeuroIndex a = 0U; a < NEURO_CORE_ATTRIBUTE_END; ++a)
+    CU_ASSERT(NeuroCoreStackGetAttributeNum(ws, (NeuroCoreAttribute)a) == 0U);
+  CU_ASSERT_PTR_NULL(NeuroCoreFindNspClient());
+}
+
+static void skip_clean_arrange(void) {
+  NeuroClient *const cli = NeuroTypeNewClient(1UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  const NeuroIndex ws = cli->ws;
+
+  // Only the first arrange after a change is executed
+  const NeuroIndex executed = NeuroLayoutGetExecutedArranges();
+  const NeuroIndex skipped = NeuroLayoutGetSkippedArranges();
+  NeuroLayoutRunCurr(ws);
+  NeuroLayoutRunCurr(ws);
+  CU_ASSERT(NeuroLayoutGetExecutedArranges() == executed + 1U);
+  CU_ASSERT(NeuroLayoutGetSkippedArranges() == skipped + 1U);
+
+  // Core mutations and explicit bumps make the stack dirty again
+  const NeuroIndex gen = NeuroCoreStackGetGeneration(ws);
+  NeuroCoreClientSetFullscreen(c, true);
+  CU_ASSERT(NeuroCoreStackGetGeneration(ws) != gen);
+  NeuroLayoutRunCurr(ws);
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRunCurr(ws);
+  CU_ASSERT(NeuroLayoutGetExecutedArranges() == executed + 3U);
+  CU_ASSERT(NeuroLayoutGetSkippedArranges() == skipped + 1U);
+
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+}
+
+static void reuse_stack_arrange(void) {
+  // The arrange workspace only grows and keeps its buffers while it fits
+  NeuroArrange *const a = NeuroCoreStackGetArrange(0U, 4U);
+  CU_ASSERT_PTR_NOT_NULL(a);
+  NeuroRectangle **const rs = a->client_regions;
+  CU_ASSERT(NeuroCoreStackGetArrange(0U, 1U) == a);
+  CU_ASSERT(NeuroCoreStackGetArrange(0U, 4U) == a);
+  CU_ASSERT(a->client_regions == rs);
+
+  // Growing it keeps the same arrange
+  CU_ASSERT(NeuroCoreStackGetArrange(0U, 1000U) == a);
+  a->client_regions[ 999 ] = NULL;
+  a->client_float_regions[ 999 ] = NULL;
+}
+
+static NeuroArrange *legacy_arranger_tall(NeuroArrange *a) {
+  return NeuroLayoutArrangerTall(a);
+}
+
+static void dense_arranger_abi(void) {
+  NeuroClient *clis[ 3 ];
+  NeuroClientPtrPtr cs[ 3 ];
+  for (NeuroIndex i = 0U; i < 3U; ++i) {
+    clis[ i ] = NeuroTypeNewClient(100UL + i, NULL);
+    CU_ASSERT_PTR_NOT_NULL(clis[ i ]);
+    cs[ i ] = NeuroCoreAddClientEnd(clis[ i ]);
+  }
+  const NeuroIndex ws = clis[ 0 ]->ws;
+  NeuroRectangle *const region = NeuroCoreStackGetRegion(ws);
+  const NeuroRectangle old_region = *region;
+  *region = (NeuroRectangle){ { 10, 20 }, 1000, 600 };
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(ws);
+  const NeuroLayout old_l = *l;
+
+  // Run the built-in arranger through the dense path
+  l->arranger_fn = NeuroLayoutArrangerTall;
+  l->mod = NEURO_LAYOUT_MOD_MIRROR | NEURO_LAYOUT_MOD_REFLECTX;
+  NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRun(ws, NeuroCoreStackGetLayoutIdx(ws));
+  NeuroRectangle dense[ 3 ];
+  memmove(dense, NeuroCoreStackGetClientRegions(ws), sizeof(dense));
+  CU_ASSERT(dense[ 0 ].w == 1000 && dense[ 1 ].w + dense[ 2 ].w == 1000);
+
+  // A config arranger using the legacy ABI gets the same result
+  l->arranger_fn = legacy_arranger_tall;
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRun(ws, NeuroCoreStackGetLayoutIdx(ws));
+  CU_ASSERT(memcmp(dense, NeuroCoreStackGetClientRegions(ws), sizeof(dense)) == 0);
+
+  *l = old_l;
+  *region = old_region;
+  NeuroCoreStackBumpGeneration(ws);
+  for (NeuroIndex i = 0U; i < 3U; ++i)
+    NeuroTypeDeleteClient(NeuroCoreRemoveClient(cs[ i ]));
+}
+
+static void fused_layout_mod(void) {
+  NeuroClient *clis[ 3 ];
+  NeuroClientPtrPtr cs[ 3 ];
+  for (NeuroIndex i = 0U; i < 3U; ++i) {
+    clis[ i ] = NeuroTypeNewClient(200UL + i, NULL);
+    CU_ASSERT_PTR_NOT_NULL(clis[ i ]);
+    cs[ i ] = NeuroCoreAddClientEnd(clis[ i ]);
+  }
+  const NeuroIndex ws = clis[ 0 ]->ws;
+  NeuroRectangle *const region = NeuroCoreStackGetRegion(ws);
+  const NeuroRectangle old_region = *region;
+  *region = (NeuroRectangle){ { 7, 13 }, 1001, 599 };
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(ws);
+  const NeuroLayout old_l = *l;
+  l->arranger_fn = NeuroLayoutArrangerTall;
+  l->dense_arranger_fn = NULL;
+
+  // Every mod combination matches the separate transpose and reflect passes
+  for (int mod = 0; mod < 8; ++mod) {
+    l->mod = (NeuroLayoutMod)mod;
+    NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
+    NeuroCoreStackBumpGeneration(ws);
+    NeuroLayoutRun(ws, NeuroCoreStackGetLayoutIdx(ws));
+
+    NeuroRectangle rects[ 3 ];
+    NeuroRectangle *rs[ 3 ] = { rects, rects + 1, rects + 2 };
+    NeuroArrange a = { 3U, *region, rs, rs, l->parameters };
+    if (mod & NEURO_LAYOUT_MOD_MIRROR)
+      NeuroGeometryRectangleTranspose(&a.region);
+    NeuroLayoutArrangerTall(&a);
+    for (NeuroIndex i = 0U; i < 3U; ++i) {
+      if (mod & NEURO_LAYOUT_MOD_MIRROR)
+        NeuroGeometryRectangleTranspose(rects + i);
+      if (mod & NEURO_LAYOUT_MOD_REFLECTX)
+        NeuroGeometryRectangleReflectX(rects + i, region);
+      if (mod & NEURO_LAYOUT_MOD_REFLECTY)
+        NeuroGeometryRectangleReflectY(rects + i, region);
+    }
+    CU_ASSERT(memcmp(rects, NeuroCoreStackGetClientRegions(ws), sizeof(rects)) == 0);
+  }
+
+  *l = old_l;
+  *region = old_region;
+  NeuroCoreStackBumpGeneration(ws);
+  for (NeuroIndex i = 0U; i < 3U; ++i)
+    NeuroTypeDeleteClient(NeuroCoreRemoveClient(cs[ i ]));
+}
+
+static void grid_arranger(void) {
+  // 5 clients: 3 columns, the first one with a single row and the last two with two rows
+  int coords[ 4*5 ];
+  NeuroDenseArrange d = { 5U, { { 10, 20 }, 100, 101 }, coords, coords + 5, coords + 10, coords + 15, NULL, NULL };
+  NeuroLayoutDenseArrangerGrid(&d);
+  const int xs[] = { 10, 43, 43, 76, 76 }, ys[] = { 20, 20, 70, 20, 70 };
+  const int ws[] = { 33, 33, 33, 34, 34 }, hs[] = { 101, 50, 51, 50, 51 };
+  CU_ASSERT(memcmp(d.xs, xs, sizeof(xs)) == 0);
+  CU_ASSERT(memcmp(d.ys, ys, sizeof(ys)) == 0);
+  CU_ASSERT(memcmp(d.ws, ws, sizeof(ws)) == 0);
+  CU_ASSERT(memcmp(d.hs, hs, sizeof(hs)) == 0);
+}
+
+static NeuroColor test_color_setter(NeuroClientPtrPtr c) {
+  (void)c;
+  return 0UL;
+}
+
+static int test_border_setter(NeuroClientPtrPtr c) {
+  (void)c;
+  return 1;
+}
+
+static void test_logger(const NeuroMonitor *m, char *str) {
+  (void)m;
+  str[ 0 ] = '\0';
+}
+
+static void merge_client_updates(void) {
+  NeuroClient *const cli = NeuroTypeNewClient(300UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(cli->ws);
+  const NeuroLayout old_l = *l;
+  l->border_color_setter_fn = test_color_setter;
+  l->border_width_setter_fn = test_border_setter;
+  l->border_gap_setter_fn = test_border_setter;
+
+  // Updates of the same window are merged until the queue is flushed
+  const NeuroIndex emitted = NeuroClientGetEmittedRequests();
+  const NeuroIndex suppressed = NeuroClientGetSuppressedRequests();
+  NeuroClientUpdate(c, NULL);
+  NeuroClientUpdate(c, NULL);
+  NeuroClientUpdate(c, NULL);
+  CU_ASSERT(NeuroClientGetEmittedRequests() == emitted);
+  CU_ASSERT(NeuroClientGetSuppressedRequests() == suppressed + 6U);
+  CU_ASSERT(cli->info->pending.border_width == 1);
+  CU_ASSERT(!cli->info->has_shadow);
+
+  // Drop the queue without sending it, there is no display
+  NeuroClientStop();
+  *l = old_l;
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+}
+
+static void render_context_setters(void) {
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(0U);
+  const NeuroLayout old_l = *l;
+  l->border_color_setter_fn = NeuroClientColorSetterAll;
+  l->border_width_setter_fn = NeuroClientBorderWidthSetterSmart;
+  l->border_gap_setter_fn = test_border_setter;
+
+  // Legacy built-in setters run their context versions, other legacy setters are adapted
+  NeuroRenderContext rc;
+  CU_ASSERT(NeuroClientGetRenderContext(&rc, 0U) == &rc);
+  CU_ASSERT(rc.color_setter_fn == NeuroClientColorContextSetterAll);
+  CU_ASSERT(rc.width_setter_fn == NeuroClientBorderWidthContextSetterSmart);
+  CU_ASSERT(rc.gap_setter_fn(NULL, &rc) == 1);
+
+  // Context setters of the layout take precedence
+  l->border_gap_context_setter_fn = NeuroClientBorderGapContextSetterNever;
+  NeuroClientGetRenderContext(&rc, 0U);
+  CU_ASSERT(rc.gap_setter_fn == NeuroClientBorderGapContextSetterNever);
+  *l = old_l;
+}
+
+static void batch_relayout(void) {
+  NeuroClient *const cli = NeuroTypeNewClient(400UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  const NeuroIndex ws = cli->ws;
+
+  // Unmanaging a client while batching only marks its stack dirty
+  NeuroEventBeginBatch();
+  NeuroEventUnmanageClient(c);
+  CU_ASSERT(NeuroCoreStackIsRelayoutPending(ws));
+  CU_ASSERT_PTR_NULL(NeuroCoreFindWindowClient(400UL));
+
+  // Clear it by hand, there is no display to relayout on
+  NeuroCoreStackSetRelayoutPending(ws, false);
+  NeuroEventEndBatch();
+  CU_ASSERT(!NeuroCoreStackIsRelayoutPending(ws));
+}
+
+static void panel_changes(void) {
+  // Panels depend on the inputs of their built-in loggers, other loggers may depend on anything
+  const NeuroDzenLoggerFn loggers[] = { NeuroDzenLoggerTime, NeuroDzenLoggerMonitorCurrLayout, NULL };
+  const NeuroDzenPanel dp = { NULL, loggers, " ", NEURO_DZEN_REFRESH_ON_EVENT, NEURO_DZEN_CHANGE_NULL };
+  CU_ASSERT(NeuroDzenGetPanelChanges(&dp) == (NEURO_DZEN_CHANGE_WORKSPACE | NEURO_DZEN_CHANGE_LAYOUT));
+  CU_ASSERT(NeuroDzenGetLoggerChanges(test_logger) == NEURO_DZEN_CHANGE_ALL);
+
+  // Changes declared by the panel take precedence
+  const NeuroDzenPanel dp_title = { NULL, loggers, " ", NEURO_DZEN_REFRESH_ON_EVENT, NEURO_DZEN_CHANGE_TITLE };
+  CU_ASSERT(NeuroDzenGetPanelChanges(&dp_title) == NEURO_DZEN_CHANGE_TITLE);
+}
+
+static void button_dispatch(void) {
+  const NeuroButton b1 = { "b1", Mod4Mask, Button1, NEURO_CHAIN_NULL(NeuroActionListNothing), false };
+  const NeuroButton b2 = { "b2", Mod4Mask|ShiftMask, Button1, NEURO_CHAIN_NULL(NeuroActionListNothing), false };
+  const NeuroButton b3 = { "b3", Mod4Mask, Button1, NEURO_CHAIN_NULL(NeuroActionListNothing), false };
+  const NeuroButton *const button_list[] = { &b1, &b2, &b3, NULL };
+  CU_ASSERT(NeuroSystemUpdateButtonBindings(button_list));
+
+  // Lock is ignored and every match is found in list order
+  const NeuroButton *found[ NEURO_SYSTEM_BINDING_MATCH_MAX ];
+  CU_ASSERT(NeuroSystemCleanMask(Mod4Mask|LockMask|Button2Mask) == Mod4Mask);
+  CU_ASSERT(NeuroSystemFindButtonBindings(found, Button1, Mod4Mask|LockMask) == 2U);
+  CU_ASSERT(found[ 0 ] == &b1 && found[ 1 ] == &b3);
+  CU_ASSERT(NeuroSystemFindButtonBindings(found, Button1, Mod4Mask|ShiftMask) == 1U);
+  CU_ASSERT(found[ 0 ] == &b2);
+  CU_ASSERT(NeuroSystemFindButtonBindings(found, Button2, Mod4Mask) == 0U);
+  CU_ASSERT(NeuroSystemUpdateButtonBindings(NULL));
+}
+
+static void idle_panel_timer(void) {
+  // Without timed panels nor cpu calc the event loop timer stays disarmed
+  CU_ASSERT(NeuroDzenGetNumPanels() == 0U);
+  CU_ASSERT(!NeuroDzenIsTicking());
+  CU_ASSERT(NeuroDzenRunFrame() == -1);
+}
+
 static void set_curr_stack(void) {
   NeuroCoreSetCurrStack(1);
   CU_ASSERT(NeuroCoreGetCurrStack() == 1);
 }
 
+static void run_dragged_client(void) {
+  NeuroClient *clis[ 2 ];
+  NeuroClientPtrPtr cs[ 2 ];
+  for (NeuroIndex i = 0U; i < 2U; ++i) {
+    clis[ i ] = NeuroTypeNewClient(300UL + i, NULL);
+    CU_ASSERT_PTR_NOT_NULL(clis[ i ]);
+    clis[ i ]->float_region = (NeuroRectangle){ { 10 + 100*(int)i, 20 }, 80, 60 };
+    cs[ i ] = NeuroCoreAddClientEnd(clis[ i ]);
+  }
+  const NeuroIndex ws = clis[ 0 ]->ws;
+  NeuroLayout *const l = NeuroCoreStackGetCurrLayout(ws);
+  const NeuroLayout old_l = *l;
+  l->arranger_fn = NeuroLayoutArrangerFloat;
+  l->dense_arranger_fn = NULL;
+  l->mod = NEURO_LAYOUT_MOD_REFLECTX;
+  NeuroGeometryTransformSetLayoutMod(&l->transform, l->mod);
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRunCurr(ws);
+
+  // Moving a float client only arranges it, the same way the whole stack would
+  clis[ 1 ]->float_region.p.x += 37;
+  const NeuroRectangle other = *NeuroCoreClientGetRegion(cs[ 0 ]);
+  CU_ASSERT(NeuroLayoutRunClient(cs[ 1 ]));
+  const NeuroRectangle moved = *NeuroCoreClientGetRegion(cs[ 1 ]);
+  CU_ASSERT(memcmp(&other, NeuroCoreClientGetRegion(cs[ 0 ]), sizeof(NeuroRectangle)) == 0);
+  NeuroCoreStackBumpGeneration(ws);
+  NeuroLayoutRunCurr(ws);
+  CU_ASSERT(memcmp(&moved, NeuroCoreClientGetRegion(cs[ 1 ]), sizeof(NeuroRectangle)) == 0);
+
+  // Tiled layouts need the whole stack
+  l->arranger_fn = NeuroLayoutArrangerTall;
+  CU_ASSERT(!NeuroLayoutRunClient(cs[ 1 ]));
+
+  *l = old_l;
+  NeuroCoreStackBumpGeneration(ws);
+  for (NeuroIndex i = 0U; i < 2U; ++i)
+    NeuroTypeDeleteClient(NeuroCoreRemoveClient(cs[ i ]));
+}
+
+static void extension_event_handler(void) {
+  // Extension events, like the sync alarm notifies, have no core handler
+  CU_ASSERT_PTR_NOT_NULL(NeuroEventGetHandler(MapRequest));
+  CU_ASSERT_PTR_NULL(NeuroEventGetHandler(LASTEvent));
+  CU_ASSERT_PTR_NULL(NeuroEventGetHandler(LASTEvent + XSyncAlarmNotify));
+}
+
+static void fetched_window_properties(void) {
+  // Fake the replies of a fixed size transient window
+  uint32_t hints[ 18 ] = { PMinSize | PMaxSize, 0U, 0U, 0U, 0U, 300U, 200U, 300U, 200U };
+  uint32_t trans = 42U;
+  unsigned char class[] = "xterm\0XTerm";
+  unsigned char title[] = "~/neurowm";
+  NeuroFetchedWindow fw;
+  memset(&fw, 0, sizeof(NeuroFetchedWindow));
+  fw.properties[ NEURO_FETCH_PROPERTY_NORMAL_HINTS ] = (XTextProperty){ (unsigned char *)hints, XA_WM_SIZE_HINTS, 32,
+      18UL };
+  fw.properties[ NEURO_FETCH_PROPERTY_CLASS ] = (XTextProperty){ class, XA_STRING, 8, sizeof(class) };
+  fw.properties[ NEURO_FETCH_PROPERTY_NAME ] = (XTextProperty){ title, XA_STRING, 8, sizeof(title) - 1U };
+  fw.properties[ NEURO_FETCH_PROPERTY_TRANSIENT_FOR ] = (XTextProperty){ (unsigned char *)&trans, XA_WINDOW, 32, 1UL };
+
+  XSizeHints size;
+  CU_ASSERT(NeuroFetchGetSizeHints(&size, &fw));
+  CU_ASSERT(size.flags == (PMinSize | PMaxSize));
+  CU_ASSERT(size.min_width == 300 && size.max_width == 300 && size.min_height == 200 && size.max_height == 200);
+  const char *cls = NULL, *name = NULL;
+  CU_ASSERT(NeuroFetchGetClassHint(&cls, &name, &fw));
+  CU_ASSERT(cls && strcmp(cls, "XTerm") == 0);
+  CU_ASSERT(name && strcmp(name, "xterm") == 0);
+  Window w = None;
+  CU_ASSERT(NeuroFetchGetTransientFor(&w, &fw) && w == 42UL);
+  CU_ASSERT(NeuroFetchGetTitle(&fw) == fw.properties + NEURO_FETCH_PROPERTY_NAME);
+
+  // Set them on a fake client, as the adoption path does
+  NeuroClient *cli = NeuroTypeNewClient(0UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  NeuroClientSetClassAndName(&cli, cls, name);
+  NeuroClientSetTitle(&cli, NeuroFetchGetTitle(&fw));
+  CU_ASSERT(cli->info->class == NeuroCoreInternString("XTerm"));
+  CU_ASSERT(cli->info->name == NeuroCoreInternString("xterm"));
+  CU_ASSERT(strcmp(cli->info->title, "~/neurowm") == 0);
+  NeuroTypeDeleteClient(cli);
+
+  // Missing or malformed properties are absent
+  fw.properties[ NEURO_FETCH_PROPERTY_NORMAL_HINTS ].nitems = 14UL;
+  fw.properties[ NEURO_FETCH_PROPERTY_TRANSIENT_FOR ].format = 8;
+  fw.properties[ NEURO_FETCH_PROPERTY_NAME ].nitems = 0UL;
+  CU_ASSERT(!NeuroFetchGetSizeHints(&size, &fw));
+  CU_ASSERT(!NeuroFetchGetTransientFor(&w, &fw));
+  CU_ASSERT_PTR_NULL(NeuroFetchGetTitle(&fw));
+}
+
+
+// Applies the restack changes to a stacking order from top to bottom
+static void apply_restack(Window *wins, NeuroIndex n, const NeuroWorkspaceRestack *changes, NeuroIndex size) {
+  for (NeuroIndex c = 0U; c < size; ++c) {
+    NeuroIndex i = 0U;
+    while (wins[ i ] != changes[ c ].win)
+      ++i;
+    memmove(wins + i, wins + i + 1U, (n - i - 1U) * sizeof(Window));
+    NeuroIndex j = 0U;
+    while (wins[ j ] != changes[ c ].sibling)
+      ++j;
+    j += changes[ c ].stack_mode == Below ? 1U : 0U;
+    memmove(wins + j + 1U, wins + j, (n - j - 1U) * sizeof(Window));
+    wins[ j ] = changes[ c ].win;
+  }
+}
+
+static void minimal_restack(void) {
+  const Window old_wins[] = { 1UL, 2UL, 3UL, 4UL };
+  NeuroWorkspaceRestack changes[ 4 ];
+
+  // The same order sends nothing
+  const NeuroIndex same[] = { 0U, 1U, 2U, 3U };
+  CU_ASSERT(NeuroWorkspaceGetRestack(changes, old_wins, same, 4U) == 0U);
+
+  // Focusing a lower window only raises it
+  const NeuroIndex raised[] = { 2U, 0U, 1U, 3U };
+  CU_ASSERT(NeuroWorkspaceGetRestack(changes, old_wins, raised, 4U) == 1U);
+  CU_ASSERT(changes[ 0 ].win == 3UL && changes[ 0 ].sibling == 1UL && changes[ 0 ].stack_mode == Above);
+
+  // Any permutation is reached, moving only the windows out of order
+  const NeuroIndex shuffled_pos[] = { 3U, 1U, 0U, 2U };
+  const Window shuffled[] = { 4UL, 2UL, 1UL, 3UL };
+  Window wins[ 4 ];
+  memcpy(wins, old_wins, sizeof(wins));
+  const NeuroIndex size = NeuroWorkspaceGetRestack(changes, old_wins, shuffled_pos, 4U);
+  CU_ASSERT(size == 2U);
+  apply_restack(wins, 4U, changes, size);
+  CU_ASSERT(memcmp(wins, shuffled, sizeof(wins)) == 0);
+
+  // Large stacks too, raising one window moves only that window
+  static Window big_old[ 1000 ], big_new[ 1000 ], big_wins[ 1000 ];
+  static NeuroIndex big_pos[ 1000 ];
+  static NeuroWorkspaceRestack big_changes[ 1000 ];
+  for (NeuroIndex i = 0U; i < 1000U; ++i) {
+    big_old[ i ] = (Window)(i + 1U);
+    big_pos[ i ] = i == 0U ? 700U : (i <= 700U ? i - 1U : i);
+  }
+  CU_ASSERT(NeuroWorkspaceGetRestack(big_changes, big_old, big_pos, 1000U) == 1U);
+  CU_ASSERT(big_changes[ 0 ].win == 701UL && big_changes[ 0 ].sibling == 1UL);
+  for (NeuroIndex i = 0U; i < 1000U; ++i)
+    big_pos[ i ] = i;
+  for (NeuroIndex i = 999U, seed = 12345U; i > 0U; --i) {
+    seed = seed*1103515245U + 12345U;
+    const NeuroIndex j = (seed >> 16U) % (i + 1U), tmp = big_pos[ i ];
+    big_pos[ i ] = big_pos[ j ];
+    big_pos[ j ] = tmp;
+  }
+  for (NeuroIndex i = 0U; i < 1000U; ++i)
+    big_new[ i ] = big_old[ big_pos[ i ] ];
+  memcpy(big_wins, big_old, sizeof(big_wins));
+  const NeuroIndex big_size = NeuroWorkspaceGetRestack(big_changes, big_old, big_pos, 1000U);
+  apply_restack(big_wins, 1000U, big_changes, big_size);
+  CU_ASSERT(memcmp(big_wins, big_new, sizeof(big_wins)) == 0);
+
+  // Adding a client makes the stacking order unknown
+  NeuroCoreStackSetStackingKnown(0U, true);
+  NeuroClient *cli = NeuroTypeNewClient(77UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  CU_ASSERT(!NeuroCoreStackIsStackingKnown(0U));
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+}
+
+static void unmapped_workspace(void) {
+  // Only stacks without a monitor are unmapped, and only in the unmap hide mode
+  const NeuroMonitor *const old_m = NeuroCoreStackGetMonitor(0U);
+  const int gaps[ 4 ] = { 0 };
+  const NeuroMonitor m = { "test", 0U, gaps, { { 0, 0 }, 800, 600 }, NULL };
+  const bool is_unmap_mode = NeuroConfigGet()->hide_mode == NEURO_HIDE_MODE_UNMAP;
+  NeuroRenderContext rc;
+  NeuroCoreStackSetMonitor(0U, &m);
+  CU_ASSERT(!NeuroWorkspaceIsUnmapped(0U));
+  CU_ASSERT(!NeuroClientGetRenderContext(&rc, 0U)->is_hidden);
+  NeuroCoreStackSetMonitor(0U, NULL);
+  CU_ASSERT(NeuroWorkspaceIsUnmapped(0U) == is_unmap_mode);
+  CU_ASSERT(NeuroClientGetRenderContext(&rc, 0U)->is_hidden == is_unmap_mode);
+  NeuroCoreStackSetMonitor(0U, old_m);
+
+  // Windows left Iconic by the hide mode are recognized on adoption
+  uint32_t state[ 2 ] = { IconicState, None };
+  NeuroFetchedWindow fw;
+  memset(&fw, 0, sizeof(NeuroFetchedWindow));
+  long s = WithdrawnState;
+  CU_ASSERT(!NeuroFetchGetWmState(&s, &fw));
+  fw.properties[ NEURO_FETCH_PROPERTY_WM_STATE ] = (XTextProperty){ (unsigned char *)state,
+      NeuroSystemGetWmAtom(NEURO_SYSTEM_WMATOM_STATE), 32, 2UL };
+  CU_ASSERT(NeuroFetchGetWmState(&s, &fw) && s == IconicState);
+}
+
+static void detached_stack(void) {
+  const NeuroMonitor *const old_m = NeuroCoreStackGetMonitor(0U);
+  const int gaps[ 4 ] = { 0 };
+  const NeuroMonitor m = { "test", 0U, gaps, { { 0, 0 }, 800, 600 }, NULL };
+  NeuroClient *const cli = NeuroTypeNewClient(500UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  *NeuroCoreClientGetRegion(c) = (NeuroRectangle){ { 10, 10 }, 100, 100 };
+
+  // Setting a monitor with the same region again does not change the geometry
+  NeuroCoreStackSetMonitor(0U, &m);
+  const NeuroIndex g = NeuroCoreStackGetGeneration(0U);
+  NeuroCoreStackSetMonitor(0U, &m);
+  CU_ASSERT(NeuroCoreStackGetGeneration(0U) == g);
+  CU_ASSERT(!NeuroClientTesterHidden(c, NULL));
+
+  // Detached stacks are hidden but keep their region, so showing them again is free
+  NeuroCoreStackDetachMonitor(0U);
+  CU_ASSERT_PTR_NULL(NeuroCoreStackGetMonitor(0U));
+  CU_ASSERT(memcmp(NeuroCoreStackGetRegion(0U), &m.region, sizeof(NeuroRectangle)) == 0);
+  CU_ASSERT(NeuroClientTesterHidden(c, NULL));
+  NeuroCoreStackSetMonitor(0U, &m);
+  CU_ASSERT(NeuroCoreStackGetGeneration(0U) == g);
+
+  // Without containers the clients are positioned relative to the root
+  NeuroPoint origin = { 1, 1 };
+  CU_ASSERT(NeuroWorkspaceGetContainer(&origin, 0U) == NeuroSystemGetRoot());
+  CU_ASSERT(origin.x == 0 && origin.y == 0);
+  NeuroRenderContext rc;
+  CU_ASSERT(NeuroClientGetRenderContext(&rc, 0U)->parent == NeuroSystemGetRoot());
+
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+  NeuroCoreStackSetMonitor(0U, old_m);
+}
+
+static void client_transaction(void) {
+  NeuroClient *const cli = NeuroTypeNewClient(600UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  CU_ASSERT(NeuroClientInit());
+
+  // Flushes inside a transaction keep the queue until the outermost transaction ends
+  const NeuroIndex emitted = NeuroClientGetEmittedRequests();
+  NeuroClientBeginTransaction();
+  NeuroClientBeginTransaction();
+  NeuroClientUpdate(c, NULL);
+  NeuroClientFlushUpdates();
+  NeuroClientEndTransaction();
+  CU_ASSERT(NeuroClientIsInTransaction());
+  NeuroClientFlushUpdates();
+  CU_ASSERT(NeuroClientGetEmittedRequests() == emitted);
+  CU_ASSERT(!cli->info->has_shadow);
+
+  // Drop the queue without sending it, there is no display
+  NeuroClientStop();
+  NeuroClientEndTransaction();
+  CU_ASSERT(!NeuroClientIsInTransaction());
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+}
+
+static void configure_request(void) {
+  NeuroClientInfo info;
+  memset(&info, 0, sizeof(NeuroClientInfo));
+  XConfigureRequestEvent ev;
+  memset(&ev, 0, sizeof(XConfigureRequestEvent));
+  ev.x = 50;
+  ev.y = 60;
+  ev.width = 300;
+  ev.height = 200;
+
+  // Without a sent geometry the requested fields are taken as they are
+  NeuroRectangle r = { { 10, 10 }, 100, 100 };
+  ev.value_mask = CWX | CWWidth;
+  NeuroClientApplyConfigureRequest(&r, &ev, &info);
+  CU_ASSERT(r.p.x == 50 && r.p.y == 10 && r.w == 300 && r.h == 100);
+
+  // Otherwise they are applied as an offset, so the border and gap of the region are kept
+  const NeuroRectangle s = { { 40, 40 }, 280, 180 };
+  info.shadow.region = s;
+  info.has_shadow = true;
+  r = (NeuroRectangle){ { 38, 38 }, 284, 184 };
+  ev.value_mask = CWX | CWY | CWWidth | CWHeight;
+  NeuroClientApplyConfigureRequest(&r, &ev, &info);
+  CU_ASSERT(r.p.x == 48 && r.p.y == 58 && r.w == 304 && r.h == 204);
+}
+
+static void configure_free_client(void) {
+  NeuroClient *const cli = NeuroTypeNewClient(620UL, NULL);
+  CU_ASSERT_PTR_NOT_NULL(cli);
+  const NeuroClientPtrPtr c = NeuroCoreAddClientStart(cli);
+  CU_ASSERT_PTR_NOT_NULL(c);
+  CU_ASSERT(NeuroClientInit());
+  NeuroRectangle *const sr = NeuroCoreStackGetRegion(cli->ws);
+  const NeuroRectangle old_sr = *sr;
+  *sr = (NeuroRectangle){ { 0, 0 }, 1000, 800 };
+  NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterCenter);
+  *NeuroCoreClientGetRegion(c) = (NeuroRectangle){ { 0, 0 }, 200, 100 };
+
+  // A centered client asking for a position keeps it instead of being centered again
+  XConfigureRequestEvent ev;
+  memset(&ev, 0, sizeof(XConfigureRequestEvent));
+  ev.value_mask = CWX | CWY;
+  ev.x = 10;
+  ev.y = 20;
+  NeuroRenderContext rc;
+  NeuroClientGetRenderContext(&rc, cli->ws);
+  CU_ASSERT(NeuroClientRequestRegion(c, &ev, &rc));
+  CU_ASSERT(cli->free_setter_fn == NeuroRuleFreeSetterFit);
+  CU_ASSERT(cli->info->pending.region.p.x == 10 && cli->info->pending.region.p.y == 20);
+
+  // Tiled clients keep the geometry of the layout
+  NeuroCoreClientSetFreeSetter(c, NeuroRuleFreeSetterNull);
+  if (!rc.is_float_layout)
+    CU_ASSERT(!NeuroClientRequestRegion(c, &ev, &rc));
+
+  // Drop the queue without sending it, there is no display
+  NeuroClientStop();
+  *sr = old_sr;
+  NeuroTypeDeleteClient(NeuroCoreRemoveClient(c));
+}
 
 //----------------------------------------------------------------------------------------------------------------------
 // MAIN
@@ -85,7 +848,32 @@ int main(int argc, const char *const *argv) {
 
   // Add the tests to the suite
   if ((NULL == CU_add_test(core_suite, "add_remove_client()", add_remove_client)) ||
-      (NULL == CU_add_test(core_suite, "set_curr_stack()", set_curr_stack))) {
+      (NULL == CU_add_test(core_suite, "find_window_client()", find_window_client)) ||
+      (NULL == CU_add_test(core_suite, "move_client_pooled()", move_client_pooled)) ||
+      (NULL == CU_add_test(core_suite, "stack_order()", stack_order)) ||
+      (NULL == CU_add_test(core_suite, "intern_string()", intern_string)) ||
+      (NULL == CU_add_test(core_suite, "client_attributes()", client_attributes)) ||
+      (NULL == CU_add_test(core_suite, "skip_clean_arrange()", skip_clean_arrange)) ||
+      (NULL == CU_add_test(core_suite, "reuse_stack_arrange()", reuse_stack_arrange)) ||
+      (NULL == CU_add_test(core_suite, "dense_arranger_abi()", dense_arranger_abi)) ||
+      (NULL == CU_add_test(core_suite, "fused_layout_mod()", fused_layout_mod)) ||
+      (NULL == CU_add_test(core_suite, "grid_arranger()", grid_arranger)) ||
+      (NULL == CU_add_test(core_suite, "merge_client_updates()", merge_client_updates)) ||
+      (NULL == CU_add_test(core_suite, "render_context_setters()", render_context_setters)) ||
+      (NULL == CU_add_test(core_suite, "batch_relayout()", batch_relayout)) ||
+      (NULL == CU_add_test(core_suite, "panel_changes()", panel_changes)) ||
+      (NULL == CU_add_test(core_suite, "button_dispatch()", button_dispatch)) ||
+      (NULL == CU_add_test(core_suite, "idle_panel_timer()", idle_panel_timer)) ||
+      (NULL == CU_add_test(core_suite, "set_curr_stack()", set_curr_stack)) ||
+      (NULL == CU_add_test(core_suite, "fetched_window_properties()", fetched_window_properties)) ||
+      (NULL == CU_add_test(core_suite, "run_dragged_client()", run_dragged_client)) ||
+      (NULL == CU_add_test(core_suite, "extension_event_handler()", extension_event_handler)) ||
+      (NULL == CU_add_test(core_suite, "minimal_restack()", minimal_restack)) ||
+      (NULL == CU_add_test(core_suite, "unmapped_workspace()", unmapped_workspace)) ||
+      (NULL == CU_add_test(core_suite, "detached_stack()", detached_stack)) ||
+      (NULL == CU_add_test(core_suite, "client_transaction()", client_transaction)) ||
+      (NULL == CU_add_test(core_suite, "configure_request()", configure_request)) ||
+      (NULL == CU_add_test(core_suite, "configure_free_client()", configure_free_client))) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------------------------------------------------
+// Program     :  grid_bench
+// Copyright   :  (c) Julian Bouzas 2014
+// License     :  BSD3-style (see LICENSE)
+// Maintainer  :  Julian Bouzas - nnoell3[at]gmail.com
+// Stability   :  stable
+//----------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------
+// PREPROCESSOR
+//----------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../neuro/layout.h"
+
+// Defines
+#define BENCH_SIZE_MAX 10000
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE VARIABLE DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+// Regions the grids are arranged in
+static const NeuroRectangle regions_[] = {
+  { { 0, 0 }, 1920, 1080 },
+  { { 7, 3 }, 1001, 599 },
+  { { 0, 0 }, 10, 10 }
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// PRIVATE FUNCTION DEFINITION
+//----------------------------------------------------------------------------------------------------------------------
+
+static double get_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void get_best_positions_and_sizes(NeuroIndex n, int total, int *positions, int *sizes) {
+  int position = 0, size = 0;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    size = total / (n - i);
+    positions[ i ] = position;
+    sizes[ i ] = size;
+    position += size;
+    total -= size;
+  }
+}
+
+// Reference Grid arranger, it computes the row partition again for every client
+static NeuroDenseArrange *reference_arranger_grid(NeuroDenseArrange *d) {
+  const NeuroIndex n = d->size;
+  NeuroIndex cols = 0U;
+  for ( ; cols <= n/2; ++cols)
+    if (cols * cols >= n)
+      break;
+  NeuroIndex rows = n / cols;
+  int xs[ cols ], ws[ cols ];
+  memset(xs, 0, sizeof(xs));
+  memset(ws, 0, sizeof(ws));
+
+  get_best_positions_and_sizes(cols, d->region.w, xs, ws);
+  NeuroIndex cn = 0U, rn = 0U;
+  for (NeuroIndex i = 0U; i < n; ++i) {
+    if (i/rows + 1 > cols - n%cols)
+      rows = n/cols + 1;
+
+    int ys[ rows ], hs[ rows ];
+    memset(ys, 0, sizeof(ys));
+    memset(hs, 0, sizeof(hs));
+    get_best_positions_and_sizes(rows, d->region.h, ys, hs);
+
+    d->xs[ i ] = d->region.p.x + xs[ cn ];
+    d->ys[ i ] = d->region.p.y + ys[ rn ];
+    d->ws[ i ] = ws[ cn ];
+    d->hs[ i ] = hs[ rn ];
+
+    if (++rn >= rows) {
+      rn = 0U;
+      ++cn;
+    }
+  }
+  return d;
+}
+
+static double run_arranger(NeuroDenseArrangerFn daf, NeuroDenseArrange *d, NeuroIndex n, const NeuroRectangle *r) {
+  d->size = n;
+  d->region = *r;
+  const double start = get_time();
+  daf(d);
+  return get_time() - start;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// MAIN
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, const char *const *argv) {
+  const NeuroIndex max = argc > 1 ? (NeuroIndex)strtoul(argv[ 1 ], NULL, 10) : BENCH_SIZE_MAX;
+  int *const coords = (int *)calloc(8U*(max + 1U), sizeof(int));
+  if (!coords) {
+    fprintf(stderr, "Could not allocate the coordinates\n");
+    return EXIT_FAILURE;
+  }
+  int *const ref_coords = coords + 4U*(max + 1U);
+  NeuroDenseArrange d = { 0U, { { 0, 0 }, 0, 0 }, coords, coords + max + 1U, coords + 2U*(max + 1U),
+      coords + 3U*(max + 1U), NULL, NULL };
+  NeuroDenseArrange ref = { 0U, { { 0, 0 }, 0, 0 }, ref_coords, ref_coords + max + 1U, ref_coords + 2U*(max + 1U),
+      ref_coords + 3U*(max + 1U), NULL, NULL };
+
+  // Arrange every size on every region with both arrangers and compare the results
+  double time = 0.0, ref_time = 0.0;
+  NeuroIndex mismatches = 0U;
+  for (NeuroIndex r = 0U; r < sizeof(regions_)/sizeof(NeuroRectangle); ++r) {
+    for (NeuroIndex n = 1U; n <= max; ++n) {
+      time += run_arranger(NeuroLayoutDenseArrangerGrid, &d, n, regions_ + r);
+      ref_time += run_arranger(reference_arranger_grid, &ref, n, regions_ + r);
+      if (memcmp(d.xs, ref.xs, n*sizeof(int)) || memcmp(d.ys, ref.ys, n*sizeof(int)) ||
+          memcmp(d.ws, ref.ws, n*sizeof(int)) || memcmp(d.hs, ref.hs, n*sizeof(int))) {
+        fprintf(stderr, "Mismatch: region %u, %u clients\n", (unsigned)r, (unsigned)n);
+        ++mismatches;
+      }
+    }
+  }
+
+  printf("Grid arranger, n = 1..%u on %u regions\n", (unsigned)max,
+      (unsigned)(sizeof(regions_)/sizeof(NeuroRectangle)));
+  printf("  reference: %10.6f s\n", ref_time);
+  printf("  current:   %10.6f s\n", time);
+  printf("  results:   %s\n", mismatches ? "DIFFERENT" : "bit-identical");
+  free(coords);
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
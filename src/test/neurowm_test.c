@@ -789,6 +789,11 @@ static const NeuroConfiguration configuration_ = {
   rule_list_,
   key_list_,
   button_list_,
+  NEURO_CONFIG_DEFAULT_MAX_BATCH_LATENCY,
+  NEURO_CONFIG_DEFAULT_LOOP_MODE,
+  NEURO_CONFIG_DEFAULT_MOTION_RATE,
+  NEURO_CONFIG_DEFAULT_HIDE_MODE,
+  NEURO_CONFIG_DEFAULT_MAX_GRAB_TIME
 };
 
 